@@ -3,8 +3,18 @@
 #include "telemetry.h"
 #include "ui_iface.h"
 #include "nav/flarm.h"
+#include "nav/traffic.h"
+#include "nav/heading.h"
+#include "policy.h"
+#include "prompts.h"
 #include "drivers/dfplayer.h"
 #include "storage/nvs_store.h"
+#include "storage/logbook.h"
+#include "storage/encounters.h"
+#include "storage/fdr.h"
+#include "util/prof.h"
+#include "util/hlog.h"
+#include "util/spsc_queue.h"
 
 // ---- Externals owned elsewhere ----
 extern Telemetry    tele;
@@ -44,12 +54,43 @@ static uint32_t landingShown_ms  = 0;  // when Landing page shown
 static uint32_t trafficHold_ms   = 0;  // min hold on TRAFFIC page
 static uint32_t lastAlertStamp   = 0;  // de-dupe alert entries
 
+// Logbook accumulators (reset at takeoff, written at LANDED)
+static uint32_t flightTakeoffUtc   = 0;
+static float    flightMaxAgl_ft    = 0.0f;
+static float    flightMinDist_m    = NAN;
+static uint16_t flightAlertsLvl[3] = {0,0,0};
+
 // Require a real climb before landing is allowed
 static bool  landing_armed = false;
 
 // NEW: allow AGL fallback takeoff only after we’ve anchored baseline this boot (or QNH adjust on ground)
 static bool  preflight_baseline_ok = false;
 
+// ---- Brown-out / crash resume ----
+// In-air flight context mirrored to RTC memory (survives a brown-out or a
+// panic/watchdog reset, not a power cycle). Cleared on the ground.
+struct FlightCtx {
+  uint32_t magic;
+  uint32_t elapsed_ms;
+  uint32_t takeoff_utc;
+  float    max_agl_ft;
+  float    min_dist_m;
+  uint16_t alerts;
+  uint16_t alerts_lvl[3];
+  uint8_t  landing_armed;
+  uint32_t check;
+};
+static const uint32_t FLIGHT_CTX_MAGIC   = 0x48414C4Fu;   // "HALO"
+static const uint32_t FLIGHT_CTX_SAVE_MS = 500;
+RTC_NOINIT_ATTR static FlightCtx rtcFlight;
+
+static uint32_t ctx_check(const FlightCtx& c){
+  const uint8_t* p = (const uint8_t*)&c;
+  uint32_t h = 2166136261u;                              // FNV-1a over everything but `check`
+  for (size_t i=0; i<offsetof(FlightCtx, check); ++i) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
 // ---- Helpers ----
 static inline float ft_from_m(float m){ return m * 3.28084f; }
 static inline float agl_ft(){
@@ -71,21 +112,161 @@ static int last_strobe_level = 0; // 0=std, 1..3=alert levels
 static inline void strobe_std(){
   strobeSet(STROBE_STD_ON_MS, STROBE_L0_PERIOD);
   last_strobe_level = 0;
-  Serial.printf("[STROBE] standard cadence: on=%ums period=%ums\n",
+  HLOGI("[STROBE] standard cadence: on=%ums period=%ums\n",
                 (unsigned)STROBE_STD_ON_MS, (unsigned)STROBE_L0_PERIOD);
 }
 static inline void strobe_alert_level(int lvl){
   uint16_t per = (lvl>=3)?STROBE_L3_PERIOD : (lvl==2)?STROBE_L2_PERIOD : STROBE_L1_PERIOD;
   strobeSet(STROBE_STD_ON_MS, per);
   last_strobe_level = lvl;
-  Serial.printf("[STROBE] alert L%d cadence: on=%ums period=%ums\n",
+  prof_trace(PROF_LAT_STROBE, alert.rx_us);
+  HLOGI("[STROBE] alert L%d cadence: on=%ums period=%ums\n",
                 lvl, (unsigned)STROBE_STD_ON_MS, (unsigned)per);
 }
 
+// Spoken callout ("HIGH" / "LEVEL" / "LOW" + o'clock) when nav/traffic.h picks a
+// new primary threat or escalates it. Escalations always speak; a new primary
+// waits out CALLOUT_MIN_GAP_MS so a busy sky doesn't chain callouts.
+static uint32_t lastCallout_ms = 0;
+static void traffic_callout(uint32_t now){
+  bool esc = false;
+  if (!traffic_take_callout(esc)) return;
+  if (!alert.active || now - alert.since >= ALERT_HOLD_MS) return;
+  if (!esc && lastCallout_ms && now - lastCallout_ms < CALLOUT_MIN_GAP_MS) return;
+  lastCallout_ms = now;
+
+  const VertCat vc  = vertical_category_ft(ft_from_m(alert.relV_m));
+  const uint16_t vtrk = prompt_track((vc == VertCat::Above) ? PROMPT_HIGH : (vc == VertCat::Below) ? PROMPT_LOW : PROMPT_LEVEL);
+  // Heading when the o'clock word is actually heard, not at the last RMC
+  const int oc = clock_from_bearings(alert.bearing_deg, heading_at(tele, now + CALLOUT_CLOCK_LEAD_MS));
+  dfp_stop_and_flush();
+  dfp_play_filename(vtrk, alert.rx_us);
+  dfp_play_filename(prompt_clock_track(oc));
+  HLOGI("[TRAFFIC] %s %d o'clock L%d%s\n", vc == VertCat::Above ? "HIGH" : vc == VertCat::Below ? "LOW" : "LEVEL",
+        oc, alert.alarm, esc ? " (escalation)" : "");
+}
+
+// Start a fresh flight record (all takeoff paths)
+static void flight_begin(uint32_t now){
+  flightStart_ms   = now;
+  flightAlertCount = 0;
+  landing_armed    = false;         // must climb past threshold to arm
+  flightTakeoffUtc = nav_utc_now();
+  flightMaxAgl_ft  = 0.0f;
+  flightMinDist_m  = NAN;
+  flightAlertsLvl[0] = flightAlertsLvl[1] = flightAlertsLvl[2] = 0;
+}
+
+// Per-tick in-flight bookkeeping for the logbook
+static void flight_track(float agl, bool alert_alive){
+  if (!isnan(agl) && agl > flightMaxAgl_ft) flightMaxAgl_ft = agl;
+  if (alert_alive && (isnan(flightMinDist_m) || alert.dist_m < flightMinDist_m)) flightMinDist_m = alert.dist_m;
+}
+
+// Closed traffic episodes: one alert per encounter (not per PFLAA sentence).
+// In the air they count toward the flight and go to the encounter log;
+// on the ground they are discarded.
+static void flight_episodes(bool inAir){
+  TrafficEpisode ep;
+  while (traffic_take_episode(ep)) {
+    if (!inAir) continue;
+    flightAlertCount++;
+    flightAlertsLvl[constrain(ep.max_level, 1, 3) - 1]++;
+
+    EncounterRecord r;
+    r.start_utc  = ep.start_utc;
+    r.id         = ep.id;
+    r.duration_s = (uint16_t)min<uint32_t>(ep.duration_ms / 1000u, 0xFFFF);
+    r.min_dist_m = (uint16_t)min(lroundf(ep.min_dist_m), 0xFFFEL);
+    r.min_vert_m = (int16_t)constrain(lroundf(ep.min_vert_m), -32768L, 32767L);
+    r.max_level  = ep.max_level;
+    r.clock      = isnan(ep.own_trk_deg) ? 0 : (uint8_t)clock_from_bearings(ep.min_brg_deg, ep.own_trk_deg);
+    encounters_append(r);
+    HLOGI("[TRAFFIC] encounter closed: L%u, %lus, min %um\n", (unsigned)r.max_level,
+          (unsigned long)r.duration_s, (unsigned)r.min_dist_m);
+  }
+}
+
+// A closed flight, written to flash by app_fsm_service() in loop()
+struct FlightClose {
+  LogbookEntry log;
+  uint32_t     flight_ms;
+  uint16_t     alerts;
+  int8_t       utc_hour, utc_min;
+};
+static SpscQueue<FlightClose, 2> closedFlights;     // control task -> loop()
+
+static void flight_close(){
+  FlightClose f;
+  f.flight_ms = lastFlightDur_ms;
+  f.alerts    = flightAlertCount;
+  f.utc_hour  = tele.utc_hour;
+  f.utc_min   = tele.utc_min;
+  LogbookEntry& e = f.log;
+  e.takeoff_utc = flightTakeoffUtc;
+  e.landing_utc = nav_utc_now();
+  e.duration_s  = lastFlightDur_ms / 1000u;
+  e.max_agl_ft  = (int16_t)constrain(lroundf(flightMaxAgl_ft), -32768L, 32767L);
+  e.min_dist_m  = isnan(flightMinDist_m) ? 0xFFFF : (uint16_t)min(lroundf(flightMinDist_m), 0xFFFEL);
+  for (int i=0; i<3; ++i) e.alerts[i] = flightAlertsLvl[i];
+  if (!closedFlights.push(f)) HLOGW("[LOG] flight record dropped (queue full)\n");
+}
+
+void app_fsm_service(){
+  FlightClose f;
+  while (closedFlights.pop(f)) {
+    nvs_record_flight(f.flight_ms, f.alerts, f.utc_hour, f.utc_min);
+    logbook_append(f.log);
+  }
+}
+
+static void flight_ctx_save(uint32_t now){
+  static uint32_t lastSave = 0;
+  const bool inAir = (g_state == ST_FLYING || g_state == ST_ALERT || g_state == ST_LANDING);
+  if (!inAir) { rtcFlight.magic = 0; return; }
+  if (rtcFlight.magic == FLIGHT_CTX_MAGIC && now - lastSave < FLIGHT_CTX_SAVE_MS) return;
+  lastSave = now;
+
+  FlightCtx c;
+  memset(&c, 0, sizeof(c));
+  c.magic         = FLIGHT_CTX_MAGIC;
+  c.elapsed_ms    = now - flightStart_ms;
+  c.takeoff_utc   = flightTakeoffUtc;
+  c.max_agl_ft    = flightMaxAgl_ft;
+  c.min_dist_m    = flightMinDist_m;
+  c.alerts        = flightAlertCount;
+  for (int i=0; i<3; ++i) c.alerts_lvl[i] = flightAlertsLvl[i];
+  c.landing_armed = landing_armed;
+  c.check         = ctx_check(c);
+  rtcFlight = c;
+}
+
+bool app_fsm_resume_flight(){
+  const FlightCtx c = rtcFlight;
+  if (c.magic != FLIGHT_CTX_MAGIC || c.check != ctx_check(c)) { rtcFlight.magic = 0; return false; }
+
+  app_fsm_init();
+  const uint32_t now = millis();
+  g_state          = ST_FLYING;
+  flightStart_ms   = now - c.elapsed_ms;       // modular: durations stay right
+  flightTakeoffUtc = c.takeoff_utc;
+  flightMaxAgl_ft  = c.max_agl_ft;
+  flightMinDist_m  = c.min_dist_m;
+  flightAlertCount = c.alerts;
+  for (int i=0; i<3; ++i) flightAlertsLvl[i] = c.alerts_lvl[i];
+  landing_armed    = c.landing_armed;
+  preflight_baseline_ok = true;
+  strobeEnable(true);
+  strobe_std();
+  ui_set_page(PAGE_COMPASS);
+  HLOGI("[FSM] resumed flight after reset (%lus airborne)\n", (unsigned long)(c.elapsed_ms / 1000u));
+  return true;
+}
+
 // NEW: baseline gate API
 void app_preflight_mark_baseline_ok(){
   preflight_baseline_ok = true;
-  Serial.println("[FSM] preflight baseline OK -> AGL fallback takeoff armed");
+  HLOGI("[FSM] preflight baseline OK -> AGL fallback takeoff armed\n");
 }
 
 void app_fsm_init(){
@@ -117,14 +298,12 @@ void app_demo_force_flying(){
   ui_set_page(PAGE_COMPASS);
 
   // Start a fresh flight so LANDED duration works in tests
-  flightStart_ms   = now;
-  flightAlertCount = 0;
-  landing_armed    = false;
+  flight_begin(now);
 
   // BENCH: inhibit landing detection briefly so ground AGL doesn’t end the flight
   demo_land_inhibit_until = now + 8000;  // 8 seconds
 
-  dfp_play_filename(3);   // takeoff cue
+  dfp_play_filename(prompt_track(PROMPT_TAKEOFF));
 }
 
 void app_fsm_tick(uint32_t now){
@@ -133,6 +312,8 @@ void app_fsm_tick(uint32_t now){
   const float agl         = agl_ft();
   const bool  alert_alive = alert.active && (now - alert.since) < ALERT_HOLD_MS;
 
+  flight_episodes(g_state == ST_FLYING || g_state == ST_ALERT || g_state == ST_LANDING);
+
   switch(g_state){
 
     case ST_PREFLIGHT: {
@@ -141,7 +322,7 @@ void app_fsm_tick(uint32_t now){
         demo_force_landing = false;
         g_state = ST_LANDING;
         strobeEnable(false);
-        dfp_play_filename(7);               // Landing cue
+        dfp_play_filename(prompt_track(PROMPT_LANDING));
         ui_set_page(PAGE_LANDING);
         landingShown_ms = now;
         break;
@@ -160,11 +341,9 @@ void app_fsm_tick(uint32_t now){
           g_state = ST_FLYING;
           strobeEnable(true);
           strobe_std();                     // standard cadence on departure
-          dfp_play_filename(3);             // Takeoff
+          dfp_play_filename(prompt_track(PROMPT_TAKEOFF));
           ui_set_page(PAGE_COMPASS);        // “Cruise”
-          flightStart_ms   = now;
-          flightAlertCount = 0;
-          landing_armed    = false;         // not armed yet
+          flight_begin(now);                // landing not armed yet
           demo_land_inhibit_until = now + 3000; // small inhibit even in real path
         }
       } else ktsHiStart_ms = 0;
@@ -176,11 +355,9 @@ void app_fsm_tick(uint32_t now){
           g_state = ST_FLYING;
           strobeEnable(true);
           strobe_std();
-          dfp_play_filename(3);
+          dfp_play_filename(prompt_track(PROMPT_TAKEOFF));
           ui_set_page(PAGE_COMPASS);
-          flightStart_ms   = now;
-          flightAlertCount = 0;
-          landing_armed    = false;         // must climb past threshold to arm
+          flight_begin(now);                // must climb past threshold to arm
           demo_land_inhibit_until = now + 3000;
         }
       } else altHiStart_ms = 0;
@@ -189,22 +366,22 @@ void app_fsm_tick(uint32_t now){
     case ST_FLYING: {
       // Arm landing once we’ve seen AGL > TAKEOFF_ALT_FT at least once
       if (!landing_armed && !isnan(agl) && agl > TAKEOFF_ALT_FT) landing_armed = true;
+      flight_track(agl, alert_alive);
 
       // Bench force-landing
       if (demo_force_landing) {
         demo_force_landing = false;
         g_state = ST_LANDING;
         strobeEnable(false);
-        dfp_play_filename(7);
+        dfp_play_filename(prompt_track(PROMPT_LANDING));
         ui_set_page(PAGE_LANDING);
         landingShown_ms = now;
         break;
       }
 
-      // Enter ALERT (and hold TRAFFIC for a minimum time)
+      // Enter ALERT (and hold TRAFFIC for a minimum time); counted per episode in flight_episodes()
       if (alert_alive && alert.since != lastAlertStamp) {
         lastAlertStamp = alert.since;
-        flightAlertCount++;
         g_state = ST_ALERT;
         ui_set_page(PAGE_TRAFFIC);
         trafficHold_ms = max(now + 1800u, alert.since + ALERT_HOLD_MS); // min show time
@@ -212,6 +389,7 @@ void app_fsm_tick(uint32_t now){
         // Speed up strobe by alert level
         if (last_strobe_level != alert.alarm) strobe_alert_level(alert.alarm);
       }
+      traffic_callout(now);
 
       // Landing detection by AGL (honor bench inhibit) — only if armed
       if (landing_armed && now >= demo_land_inhibit_until && !isnan(agl) && agl <= LANDING_ALT_FT) {
@@ -219,7 +397,7 @@ void app_fsm_tick(uint32_t now){
         if (now - landLowStart_ms >= 2000) {
           g_state = ST_LANDING;
           strobeEnable(false);
-          dfp_play_filename(7);
+          dfp_play_filename(prompt_track(PROMPT_LANDING));
           ui_set_page(PAGE_LANDING);
           landingShown_ms = now;
         }
@@ -227,8 +405,11 @@ void app_fsm_tick(uint32_t now){
     } break;
 
     case ST_ALERT: {
+      flight_track(agl, alert_alive);
+
       // Keep strobe rate in sync with current alert level
       if (last_strobe_level != alert.alarm) strobe_alert_level(alert.alarm);
+      traffic_callout(now);
 
       // Exit ALERT when expired & hold satisfied
       if (!alert_alive && now >= trafficHold_ms) {
@@ -243,7 +424,7 @@ void app_fsm_tick(uint32_t now){
         if (now - landLowStart_ms >= 2000) {
           g_state = ST_LANDING;
           strobeEnable(false);
-          dfp_play_filename(7);
+          dfp_play_filename(prompt_track(PROMPT_LANDING));
           ui_set_page(PAGE_LANDING);
           landingShown_ms = now;
         }
@@ -255,16 +436,15 @@ void app_fsm_tick(uint32_t now){
       if (!isnan(kts) && kts < 5.0f) {
         if (!landedSlow_ms) landedSlow_ms = now;
         if (now - landedSlow_ms >= 3000) {
+          traffic_close_episodes();         // count encounters still open at touchdown
+          flight_episodes(true);
           g_state = ST_LANDED;
           if (flightStart_ms) lastFlightDur_ms = now - flightStart_ms;
           ui_set_page(PAGE_LANDED);
 
-          // Persist this flight in NVS (duration, alert count, UTC snapshot)
-          nvs_record_flight(
-            lastFlightDur_ms,
-            flightAlertCount,
-            tele.utc_hour, tele.utc_min
-          );
+          // NVS totals (duration, alert count, UTC snapshot) + logbook record, written by loop()
+          flight_close();
+          fdr_flush();                      // commit the recorder's partial page
         }
       } else landedSlow_ms = 0;
 
@@ -281,8 +461,11 @@ void app_fsm_tick(uint32_t now){
       ui_set_page(PAGE_BOOT);
       break;
   }
+
+  flight_ctx_save(now);
 }
 
 // ---- Landed stats getters ----
 uint32_t app_last_flight_duration_ms(){ return lastFlightDur_ms; }
 uint16_t app_last_flight_alerts(){ return flightAlertCount; }
+int      app_strobe_level(){ return last_strobe_level; }
@@ -13,12 +13,19 @@ enum AppState : uint8_t {
 extern AppState g_state;
 
 void app_fsm_init();              // call once devices are up
+// After an unplanned reset (brown-out, panic, watchdog): if RTC memory holds a
+// valid in-air flight context, resume that flight in FLYING and return true.
+bool app_fsm_resume_flight();
 void app_fsm_tick(uint32_t now);  // call each loop after sensors/nav
+void app_fsm_service();           // loop(): write closed flights to NVS and the logbook
 
 // Landed stats exposure (used by Landed screen)
 uint32_t app_last_flight_duration_ms();
 uint16_t app_last_flight_alerts();
 
+// Current strobe cadence level (0=standard, 1..3=alert)
+int app_strobe_level();
+
 // Bench/demo helpers
 void app_demo_force_landing();                 // force LANDING
 void app_demo_force_flying();                  // force FLYING so alerts change cadence
@@ -12,6 +12,48 @@ static constexpr uint32_t LANDING_HOLD_MS        = 8000;      // show Landing sc
 static constexpr uint32_t FLARM_TIMEOUT_MS       = 8000;
 static constexpr uint32_t FLARM_EDGE_HYST_MS     = 500;
 
+// ---- Traffic / threat selection (nav/traffic.h) ----
+static constexpr uint32_t TRAFFIC_STALE_MS       = 4000;      // drop a target after this long without PFLAA
+static constexpr float    TRAFFIC_PROX_M         = 1500.0f;   // alarm-0 targets count as threats inside this range...
+static constexpr float    TRAFFIC_PROX_VERT_M    = 300.0f;    // ...and this vertical band
+static constexpr uint32_t THREAT_MIN_DWELL_MS    = 3000;      // keep the primary at least this long
+static constexpr float    THREAT_SWITCH_MARGIN   = 1.25f;     // challenger must score 25% higher to take over
+static constexpr uint32_t THREAT_LEVEL_DOWN_MS   = 2000;      // alarm level must stay lower this long to step down
+static constexpr uint32_t CALLOUT_MIN_GAP_MS     = 4000;      // between spoken callouts (escalations excepted)
+static constexpr float    CPA_HORIZON_S          = 60.0f;     // don't predict further ahead than this
+static constexpr float    CPA_MISS_M             = 300.0f;    // predicted miss inside this raises the level...
+static constexpr float    CPA_MISS_VERT_M        = 150.0f;    // ...if also this close vertically at CPA
+static constexpr float    CPA_L1_S               = 18.0f;     // time-to-CPA bands for levels 1/2/3
+static constexpr float    CPA_L2_S               = 12.0f;
+static constexpr float    CPA_L3_S               = 8.0f;
+static constexpr uint8_t  CPA_MIN_VEL_SAMPLES    = 3;         // differenced fixes before a CPA may raise the level
+static constexpr uint32_t TRAFFIC_DR_MAX_MS      = 3000;      // UI dead reckoning stops after this
+static constexpr uint32_t EPISODE_QUIET_MS       = 10000;     // alarm-free time that closes an encounter
+
+// ---- Own-ship heading estimate (nav/heading.h) ----
+static constexpr float    HEADING_MIN_KTS        = 10.0f;     // no turn rate below this ground speed
+static constexpr uint32_t HEADING_FIX_GAP_MS     = 3000;      // longer RMC gap restarts the estimate
+static constexpr float    HEADING_MAX_DPS        = 45.0f;     // clamp (tight thermal ~20-25 deg/s)
+static constexpr float    HEADING_RATE_ALPHA     = 0.6f;      // weight of the newest fix in the rate
+static constexpr uint32_t HEADING_FIX_LAG_MS     = 200;       // RMC epoch -> sentence on the UART
+static constexpr uint32_t HEADING_PREDICT_MAX_MS = 2000;      // don't extrapolate further than this
+static constexpr uint32_t CALLOUT_CLOCK_LEAD_MS  = 700;       // "HIGH"/"LOW" word before the o'clock word
+
+// ---- Airfield auto-setup (nav/airfields.h) ----
+static constexpr float    AIRFIELD_MATCH_M       = 3000.0f;   // farther from any reference point: no match
+static constexpr float    AIRFIELD_MAX_KTS       = 5.0f;      // only while (nearly) stationary
+static constexpr uint32_t AIRFIELD_POS_AGE_MS    = 3000;      // position must be this fresh
+static constexpr uint32_t AIRFIELD_RETRY_MS      = 10000;     // re-try a miss at this interval
+
+// ---- Barometer profiles (drivers/baro.h) ----
+static constexpr float    BARO_ROLL_KTS          = 10.0f;     // on the ground above this: takeoff roll, sample fast
+static constexpr uint32_t BARO_CLIMBOUT_MS       = 60000;     // fast sampling this long after takeoff
+static constexpr float    BARO_APPROACH_FT       = 1000.0f;   // and below this AGL (approach, landing detector)
+static constexpr float    BARO_CLIMB_MS          = 1.5f;      // without nav: a climb this fast on the ground...
+static constexpr float    BARO_CLIMB_FT          = 50.0f;     // ...or this far above the baseline means a launch
+static constexpr uint32_t BARO_RELAX_MS          = 5000;      // a slower profile must be wanted this long
+static constexpr float    BARO_VS_TAU_S          = 1.0f;      // vertical speed smoothing time constant
+
 // ---- Audio sequencing ----
 static constexpr uint32_t AUDIO_PART2_GUARD_MS   = 1200;
 
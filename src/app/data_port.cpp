@@ -0,0 +1,150 @@
+#include "data_port.h"
+#include "live_frame.h"
+#include "state_store.h"
+#include "../nav/flarm.h"
+#include "../nav/gdl90.h"
+#include "../util/hlog.h"
+
+static const size_t     LINE_BYTES  = 128;               // as the UART framer (nav/flarm.cpp)
+static const size_t     FRAME_BYTES = 64;                // GDL90 reports are 28 + CRC; uplink frames are skipped
+static const size_t     RX_CHUNK    = 256;
+static const TickType_t FEED_WAIT   = pdMS_TO_TICKS(50);
+
+enum RxState : uint8_t { RX_TEXT, RX_FRAME, RX_ESC, RX_AFTER };
+
+static volatile bool active = false;
+static RxState  rx = RX_TEXT;
+static char     line[LINE_BYTES];
+static uint8_t  lineLen = 0;
+static bool     lineBad = false;
+static uint8_t  frame[FRAME_BYTES];
+static uint8_t  frameLen = 0;
+static bool     frameBad = false;
+
+static uint8_t  rateHz = DP_DEFAULT_HZ;
+static uint32_t nextState = 0, nextStats = 0;
+static uint32_t nLines = 0, nFrames = 0, nDropped = 0, nBad = 0;
+static uint32_t rxBytes = 0, rxFull = 0, rxAcked = 0;
+
+bool dataport_active(){ return active; }
+
+void dataport_enter(){
+  if (active) return;
+  Serial.printf("[DATA] USB data port: NMEA/GDL90 in, state frames out; send [0x%02X]['C'] to leave\n", DP_MSG_CTRL);
+  Serial.flush();
+  rx = RX_TEXT; lineLen = 0; lineBad = false; frameLen = 0; frameBad = false;
+  rateHz = DP_DEFAULT_HZ; nextState = nextStats = millis();
+  nLines = nFrames = nDropped = nBad = 0;
+  rxBytes = rxFull = rxAcked = 0;
+  hlog_set_muted(true);
+  active = true;
+}
+
+static void leave(){
+  active = false;
+  hlog_set_muted(false);
+  Serial.printf("\n[DATA] console; %lu lines, %lu frames, %lu dropped, %lu bad, RX full %lu\n",
+                (unsigned long)nLines, (unsigned long)nFrames, (unsigned long)nDropped, (unsigned long)nBad,
+                (unsigned long)rxFull);
+}
+
+static void send(const uint8_t* msg, size_t n){
+  uint8_t out[2 * (2 + sizeof(HaloLiveFrame)) + 6];
+  const size_t k = gdl90_frame(out, sizeof(out), msg, n);
+  if (k) Serial.write(out, k);
+}
+
+static void on_frame(){
+  if (frameBad || frameLen < 3) { nBad++; return; }
+  const size_t n = frameLen - 2;
+  if (gdl90_crc(frame, n) != (uint16_t)(frame[n] | (frame[n + 1] << 8))) { nBad++; return; }
+  if (frame[0] == DP_MSG_CTRL) {
+    if (n >= 2 && frame[1] == 'C') leave();
+    else if (n >= 3 && frame[1] == 'R') rateHz = min<uint8_t>(frame[2], DP_MAX_HZ);
+    return;
+  }
+  if (nav_feed_gdl90(frame, n, FEED_WAIT)) nFrames++; else nDropped++;
+}
+
+static void on_line(){
+  if (!lineBad && lineLen && line[0] == '$') {
+    if (nav_feed_line(line, lineLen, FEED_WAIT)) nLines++; else nDropped++;
+  } else if (lineLen || lineBad) {
+    nBad++;
+  }
+  lineLen = 0; lineBad = false;
+}
+
+static void frame_byte(uint8_t c){
+  if (frameLen < FRAME_BYTES) frame[frameLen++] = c; else frameBad = true;
+}
+
+static void open_frame(){ frameLen = 0; frameBad = false; rx = RX_FRAME; }
+
+// Text outside frames is NMEA; after a closing flag the next byte may start
+// another frame without its own flag (shared flags), unless it is the '$' of
+// a line.
+static void rx_byte(uint8_t c){
+  switch (rx) {
+    case RX_AFTER:
+      if (c == GDL90_FLAG) { open_frame(); return; }
+      if (c == '$') { rx = RX_TEXT; break; }            // '\n' is the Ownship id, not a line end
+      open_frame();
+      frame_byte(c);
+      return;
+    case RX_FRAME:
+      if (c == GDL90_FLAG) { if (frameLen) { on_frame(); rx = RX_AFTER; } return; }
+      if (c == GDL90_ESC) rx = RX_ESC; else frame_byte(c);
+      return;
+    case RX_ESC:
+      if (c == GDL90_FLAG) { nBad++; open_frame(); return; }   // aborted frame
+      frame_byte(c ^ 0x20);
+      rx = RX_FRAME;
+      return;
+    case RX_TEXT:
+      break;
+  }
+  if (c == GDL90_FLAG) { if (lineLen || lineBad) { nBad++; lineLen = 0; lineBad = false; } open_frame(); return; }
+  if (c == '\r') return;
+  if (c == '\n') { on_line(); return; }
+  if (lineLen < LINE_BYTES - 1) line[lineLen++] = (char)c; else lineBad = true;
+}
+
+void dataport_poll(uint32_t now){
+  if (!active) return;
+  static uint8_t buf[RX_CHUNK];
+  for (size_t total = 0; total < DP_RX_BUFFER && active; ) {   // bounded, so outbound frames keep flowing
+    const int avail = Serial.available();
+    if (avail <= 0) break;
+    if ((size_t)avail >= DP_RX_BUFFER) rxFull++;              // the ISR may have dropped bytes since
+    const size_t n = Serial.read(buf, min((size_t)avail, sizeof(buf)));
+    for (size_t i = 0; i < n && active; ++i) rx_byte(buf[i]);
+    total += n;
+    rxBytes += n;
+  }
+  if (!active) return;
+
+  if (rateHz && (int32_t)(now - nextState) >= 0) {
+    const uint32_t period = 1000u / rateHz;
+    nextState = ((int32_t)(now - nextState) > (int32_t)period) ? now + period : nextState + period;
+    static HaloState st;
+    static uint32_t  seen = 0;
+    state_read(st, seen);
+    uint8_t msg[2 + sizeof(HaloLiveFrame)];
+    msg[0] = DP_MSG_STATE;
+    msg[1] = LIVE_FRAME_VERSION;
+    HaloLiveFrame f;
+    live_frame_fill(f, st, now);
+    memcpy(&msg[2], &f, sizeof(f));
+    send(msg, sizeof(msg));
+  }
+  if ((int32_t)(now - nextStats) >= 0 || rxBytes - rxAcked >= DP_RX_WINDOW / 4) {   // also the host's credit
+    nextStats = now + 1000;
+    rxAcked = rxBytes;
+    uint8_t msg[1 + 6 * 4];
+    const uint32_t v[6] = { nLines, nFrames, nDropped, nBad, rxBytes, rxFull };
+    msg[0] = DP_MSG_STATS;
+    memcpy(&msg[1], v, sizeof(v));
+    send(msg, sizeof(msg));
+  }
+}
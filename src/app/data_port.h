@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+
+// USB data port for hardware-in-the-loop runs. Console key D switches the USB
+// CDC link from debug text + keys to a framed data stream; a control frame
+// switches it back. While active, deferred logs are muted.
+//
+// Inbound, the stream mixes:
+//   - NMEA lines ("$...\r\n"), queued to the parser exactly like UART lines
+//   - GDL90 frames (nav/gdl90.h), CRC-checked and queued to the same parser
+//   - control frames, GDL90-framed with id DP_MSG_CTRL:
+//       [DP_MSG_CTRL]['C']      back to the console
+//       [DP_MSG_CTRL]['R'][hz]  state frame rate, 0..DP_MAX_HZ (0 = off)
+//
+// Flow control: the USB CDC ISR drops bytes once the RX buffer is full, so
+// the host must not rely on USB back-pressure. It keeps at most DP_RX_WINDOW
+// bytes in flight, counting from the rx_bytes total in the latest stats
+// frame (bytes taken out of the RX buffer and handled). Stats frames go out
+// once a second and as soon as rx_bytes has moved DP_RX_WINDOW / 4 further.
+//
+// Outbound, GDL90-framed:
+//   [DP_MSG_STATE][LIVE_FRAME_VERSION][HaloLiveFrame]    at the selected rate
+//   [DP_MSG_STATS][lines][frames][dropped][bad][rx_bytes][rx_full]   u32 each
+// rx_full counts polls that found the RX buffer full, i.e. input may have
+// been lost; it stays 0 for a host that honours the window.
+// Text printed directly to Serial (boot, BLE bring-up) can still appear
+// between frames; hosts skip anything outside a valid frame.
+static constexpr uint8_t DP_MSG_STATE = 0x48;   // 'H'
+static constexpr uint8_t DP_MSG_STATS = 0x49;
+static constexpr uint8_t DP_MSG_CTRL  = 0x4A;
+static constexpr uint8_t DP_DEFAULT_HZ = 10;
+static constexpr uint8_t DP_MAX_HZ     = 50;
+static constexpr size_t  DP_RX_BUFFER  = 4096;  // Serial RX buffer, sized before Serial.begin()
+static constexpr size_t  DP_RX_WINDOW  = DP_RX_BUFFER / 2;
+
+void dataport_enter();                 // console key D
+bool dataport_active();
+void dataport_poll(uint32_t now);      // loop(), instead of the console keys while active
@@ -0,0 +1,36 @@
+#include "live_frame.h"
+#include "state_store.h"
+#include "constants.h"
+
+static inline int16_t  clamp_i16(long v){ return (int16_t)constrain(v, -32767L, 32767L); }
+static inline uint16_t clamp_u16(long v){ return (uint16_t)constrain(v, 0L, 65534L); }
+
+void live_frame_fill(HaloLiveFrame& f, const HaloState& st, uint32_t now){
+  const Telemetry&    tele  = st.tele;
+  const TrafficAlert& alert = st.alert;
+  f.t_ms      = now;
+  f.utc_epoch = tele.utc_epoch ? tele.utc_epoch + (now - tele.last_nmea_ms) / 1000u : 0;
+  f.alt_dm    = isnan(tele.alt_m) ? INT32_MIN : (int32_t)lroundf(tele.alt_m * 10.0f);
+  f.agl_ft    = (st.baselineSet && !isnan(tele.alt_m)) ? clamp_i16(lroundf(m_to_ft(tele.alt_m - st.baselineAlt_m))) : INT16_MIN;
+  f.vs_cms    = clamp_i16(lroundf(tele.vs_ms * 100.0f));
+  f.sog_dkt   = isnan(tele.sog_kts)   ? 0xFFFF : clamp_u16(lroundf(tele.sog_kts * 10.0f));
+  f.trk_ddeg  = isnan(tele.track_deg) ? 0xFFFF : clamp_u16(lroundf(tele.track_deg * 10.0f));
+  f.temp_dC   = isnan(tele.tC)        ? INT16_MIN : clamp_i16(lroundf(tele.tC * 10.0f));
+  f.state        = (uint8_t)st.state;
+  f.strobe_level = st.strobe_level;
+
+  const bool alive = alert.active && (now - alert.since) < ALERT_HOLD_MS;
+  f.flags = (st.nav_ok      ? LF_NAV_VALID   : 0)
+          | (tele.bmp_ok    ? LF_BMP_OK      : 0)
+          | (st.baselineSet ? LF_BASELINE    : 0)
+          | (st.strobe_on   ? LF_STROBE_ON   : 0)
+          | (alive          ? LF_ALERT_ALIVE : 0);
+
+  f.alarm        = (uint8_t)constrain(alert.alarm, 0, 255);
+  f.alert_age_ms = alert.active ? (uint16_t)min(now - alert.since, (uint32_t)0xFFFF) : 0xFFFF;
+  f.relN_m       = clamp_i16(lroundf(alert.relN_m));
+  f.relE_m       = clamp_i16(lroundf(alert.relE_m));
+  f.relV_m       = clamp_i16(lroundf(alert.relV_m));
+  f.dist_m       = clamp_u16(lroundf(alert.dist_m));
+  f.bearing_ddeg = clamp_u16(lroundf(alert.bearing_deg * 10.0f));
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+
+// Packed little-endian snapshot of Telemetry + TrafficAlert + g_state.
+// Wire format shared by the BLE live stream; bump LIVE_FRAME_VERSION on change.
+static constexpr uint8_t LIVE_FRAME_VERSION = 1;
+
+struct __attribute__((packed)) HaloLiveFrame {
+  uint32_t t_ms;            // millis() at capture
+  uint32_t utc_epoch;       // unix seconds, 0 = unknown
+  int32_t  alt_dm;          // MSL decimetres, INT32_MIN = unknown
+  int16_t  agl_ft;          // INT16_MIN = no baseline
+  int16_t  vs_cms;          // vertical speed cm/s
+  uint16_t sog_dkt;         // 0.1 kt, 0xFFFF = unknown
+  uint16_t trk_ddeg;        // 0.1 deg, 0xFFFF = unknown
+  int16_t  temp_dC;         // 0.1 C, INT16_MIN = unknown
+  uint8_t  state;           // AppState
+  uint8_t  flags;           // LF_* bits
+  uint8_t  strobe_level;    // 0 std, 1..3 alert cadence
+  uint8_t  alarm;           // 0..3
+  uint16_t alert_age_ms;    // ms since alert.since, saturates at 0xFFFF
+  int16_t  relN_m;
+  int16_t  relE_m;
+  int16_t  relV_m;
+  uint16_t dist_m;
+  uint16_t bearing_ddeg;
+};
+static_assert(sizeof(HaloLiveFrame) == 38, "live frame is a wire format");
+
+enum : uint8_t {
+  LF_NAV_VALID   = 0x01,
+  LF_BMP_OK      = 0x02,
+  LF_BASELINE    = 0x04,
+  LF_STROBE_ON   = 0x08,
+  LF_ALERT_ALIVE = 0x10,
+};
+
+struct HaloState;
+void live_frame_fill(HaloLiveFrame& f, const HaloState& st, uint32_t now);
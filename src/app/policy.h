@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include "../util/fixed_trig.h"
 
 // --- Strobe periods by alert level (ms) ---
 // Make this header self-contained so it doesn’t rely on other headers.
@@ -16,14 +17,10 @@ inline uint16_t strobe_period_for_level(int alarm){
   return STROBE_PERIOD_L0;
 }
 
-// 12-o’clock sector from absolute bearing and own heading
+// 12-o’clock sector from absolute bearing and own heading (BAM difference wraps for free)
 inline int clock_from_bearings(float target_abs_deg, float own_heading_deg){
   if (!(own_heading_deg==own_heading_deg)) own_heading_deg = 0.0f; // NaN guard
-  float rel = target_abs_deg - own_heading_deg;
-  while (rel < 0)      rel += 360.0f;
-  while (rel >= 360.0f) rel -= 360.0f;
-  int sector = ((int)((rel + 15.0f) / 30.0f)) % 12;
-  return sector == 0 ? 12 : sector;
+  return clock_sector((bam16_t)(bam_from_deg(target_abs_deg) - bam_from_deg(own_heading_deg)));
 }
 
 // Vertical category (ft)
@@ -0,0 +1,106 @@
+#include "power.h"
+#include "app_fsm.h"
+#include "telemetry.h"
+#include "constants.h"
+#include "rtos_cfg.h"
+#include "data_port.h"
+#include "../nav/flarm.h"
+#include "../util/prof.h"
+#include "../util/hlog.h"
+
+#include <sdkconfig.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+static volatile PowerMode mode = PWR_FULL;
+static uint32_t groundSince = 0;
+static bool     pmActive    = false;   // esp_pm available and configured
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t lockFreq  = nullptr;   // CPU_FREQ_MAX while PWR_FULL
+static esp_pm_lock_handle_t lockAwake = nullptr;   // NO_LIGHT_SLEEP while full or UART busy
+static bool awakeHeld = false;
+static bool rxWake    = false;   // nav RX pin can wake the chip from light sleep
+
+static void hold_awake(bool on){
+  if (on == awakeHeld) return;
+  if (on) esp_pm_lock_acquire(lockAwake); else esp_pm_lock_release(lockAwake);
+  awakeHeld = on;
+}
+
+// Only UART0/1 have a light-sleep wakeup on the S3 and the nav link is on
+// UART2, so the RX pin wakes the chip as a GPIO instead: the line idles high
+// and every start bit pulls it low. The bytes received before the clocks are
+// back are lost, which only ever hits the first line of a stream that was
+// quiet for POWER_UART_QUIET_MS.
+static bool enable_rx_wake(int pin){
+  const esp_err_t e1 = gpio_wakeup_enable((gpio_num_t)pin, GPIO_INTR_LOW_LEVEL);
+  const esp_err_t e2 = (e1 == ESP_OK) ? esp_sleep_enable_gpio_wakeup() : ESP_OK;
+  if (e1 == ESP_OK && e2 == ESP_OK) return true;
+  Serial.printf("[PWR] RX wake on GPIO%d failed (%s / %s); no light sleep\n",
+                pin, esp_err_to_name(e1), esp_err_to_name(e2));
+  return false;
+}
+#endif
+
+void power_begin(int navRxPin){
+#if CONFIG_PM_ENABLE
+  esp_pm_config_esp32s3_t cfg = {};
+  cfg.max_freq_mhz = POWER_FULL_MHZ;
+  cfg.min_freq_mhz = POWER_GROUND_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  cfg.light_sleep_enable = true;
+#endif
+  if (esp_pm_configure(&cfg) == ESP_OK
+      && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX,   0, "halo_full",  &lockFreq)  == ESP_OK
+      && esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "halo_awake", &lockAwake) == ESP_OK) {
+    esp_pm_lock_acquire(lockFreq);
+    hold_awake(true);
+    rxWake   = enable_rx_wake(navRxPin);
+    pmActive = true;
+  }
+#else
+  (void)navRxPin;
+#endif
+  Serial.printf("[PWR] %s\n", pmActive ? "esp_pm DFS/light sleep" : "setCpuFrequencyMhz fallback (no esp_pm)");
+}
+
+static void set_mode(PowerMode m){
+  mode = m;
+  const uint32_t mhz = (m == PWR_FULL) ? POWER_FULL_MHZ : POWER_GROUND_MHZ;
+#if CONFIG_PM_ENABLE
+  if (pmActive) {
+    if (m == PWR_FULL) { esp_pm_lock_acquire(lockFreq); hold_awake(true); }
+    else               esp_pm_lock_release(lockFreq);
+  }
+#endif
+  if (!pmActive) setCpuFrequencyMhz(mhz);
+  prof_set_cpu_mhz(mhz);
+  HLOGI("[PWR] %s (%lu MHz)\n", m == PWR_FULL ? "full" : "ground", (unsigned long)mhz);
+}
+
+void power_tick(uint32_t now){
+  const bool alertAlive = alert.active && (now - alert.since) < ALERT_HOLD_MS;
+  const bool ground     = (g_state == ST_PREFLIGHT || g_state == ST_LANDED) && !alertAlive
+                       && !dataport_active();   // HIL replay runs at full clock
+
+  if (!ground) {
+    groundSince = 0;
+    if (mode != PWR_FULL) set_mode(PWR_FULL);
+    return;
+  }
+  if (!groundSince) groundSince = now | 1;
+  if (mode == PWR_FULL && now - groundSince >= POWER_GROUND_DWELL_MS) set_mode(PWR_GROUND);
+
+#if CONFIG_PM_ENABLE
+  if (pmActive && mode == PWR_GROUND) hold_awake(!rxWake || now - nav_last_rx_ms() < POWER_UART_QUIET_MS);
+#endif
+}
+
+PowerMode power_mode(){ return mode; }
+
+uint32_t power_nav_poll_ms(){ return mode == PWR_FULL ? NAV_POLL_MS : NAV_POLL_GROUND_MS; }
+uint32_t power_control_period_ms(){ return mode == PWR_FULL ? CONTROL_PERIOD_MS : CONTROL_PERIOD_GROUND_MS; }
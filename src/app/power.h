@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+// Power manager tied to the flight state.
+//   PWR_FULL   : 240 MHz, no light sleep (boot, flying, alert, landing, any live alert)
+//   PWR_GROUND : CPU may drop to 80 MHz (the BLE floor); automatic light sleep is
+//                allowed while the nav UART is quiet, waking on an RX pin edge, timers and BLE
+//                (never while the USB data port is active)
+// Steps up at once; steps down only after POWER_GROUND_DWELL_MS on the ground.
+enum PowerMode : uint8_t { PWR_FULL, PWR_GROUND };
+
+static constexpr uint32_t POWER_FULL_MHZ        = 240;
+static constexpr uint32_t POWER_GROUND_MHZ      = 80;
+static constexpr uint32_t POWER_GROUND_DWELL_MS = 10000;
+static constexpr uint32_t POWER_UART_QUIET_MS   = 2000;   // no RX for this long -> light sleep allowed
+
+void      power_begin(int navRxPin);     // configure DFS / light sleep (if the SDK supports it)
+void      power_tick(uint32_t now);      // control task, after app_fsm_tick()
+PowerMode power_mode();
+
+// Task periods for the current mode (ground mode relaxes polling; alerts are unaffected
+// because the control task is woken by each NMEA line regardless of its period)
+uint32_t  power_nav_poll_ms();
+uint32_t  power_control_period_ms();
@@ -0,0 +1,35 @@
+#include "prompts.h"
+#include "../storage/assets.h"
+#include <Arduino.h>
+
+static const char* const NAMES[PROMPT_COUNT] = {
+  "boot", "nav_ok", "takeoff", "landing", "level", "high", "low",
+  "clock1", "clock2", "clock3", "clock4", "clock5", "clock6",
+  "clock7", "clock8", "clock9", "clock10", "clock11", "clock12",
+};
+
+// Built-in card layout: clock words are 21..32
+static uint16_t tracks[PROMPT_COUNT] = {
+  1, 2, 3, 7, 10, 11, 12,
+  21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+};
+
+void prompts_load(){
+  uint16_t n = 0;
+  const AssetPrompt* m = assets_manifest("prompts", n);
+  if (!m) return;
+  uint8_t applied = 0;
+  for (uint16_t i=0; i<n; ++i) {
+    for (uint8_t p=0; p<PROMPT_COUNT; ++p) {
+      if (strncmp(m[i].name, NAMES[p], sizeof(m[i].name)) != 0) continue;
+      if (m[i].track >= 1 && m[i].track <= 3000) { tracks[p] = m[i].track; applied++; }
+      else Serial.printf("[ASSETS] prompt '%s': track %u out of range\n", NAMES[p], (unsigned)m[i].track);
+      break;
+    }
+  }
+  Serial.printf("[ASSETS] prompt manifest: %u of %u entries applied\n", (unsigned)applied, (unsigned)n);
+}
+
+uint16_t prompt_track(Prompt p){
+  return p < PROMPT_COUNT ? tracks[p] : 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// Audio prompts by meaning rather than DFPlayer file number. The built-in
+// numbering matches the SD card layout shipped so far; a "prompts" manifest in
+// the asset partition (storage/assets.h) overrides any entry by name, so a new
+// card layout needs only a new asset image.
+enum Prompt : uint8_t {
+  PROMPT_BOOT,        // boot chime
+  PROMPT_NAV_OK,      // nav became valid
+  PROMPT_TAKEOFF,
+  PROMPT_LANDING,
+  PROMPT_LEVEL,       // traffic vertical: same level
+  PROMPT_HIGH,
+  PROMPT_LOW,
+  PROMPT_CLOCK_1,     // ... PROMPT_CLOCK_1 + 11 = twelve o'clock
+  PROMPT_COUNT = PROMPT_CLOCK_1 + 12
+};
+
+void     prompts_load();            // after assets_begin(), before the first prompt plays
+uint16_t prompt_track(Prompt p);
+inline uint16_t prompt_clock_track(int oclock){    // 1..12, anything else -> 12
+  if (oclock < 1 || oclock > 12) oclock = 12;
+  return prompt_track((Prompt)(PROMPT_CLOCK_1 + oclock - 1));
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+
+// ---- Task layout ----
+// Core 1 carries the alert path (nav ingest -> FSM -> strobe/audio requests);
+// core 0 shares time with the BLE host and runs audio and the display, so a
+// slow frame or BLE burst never delays an alert.
+// Arduino loop() stays on core 1 at priority 1 as the housekeeping task.
+static constexpr BaseType_t  CORE_ALERT          = 1;
+static constexpr BaseType_t  CORE_AUX            = 0;
+
+static constexpr UBaseType_t PRIO_NAV            = 6;   // UART framing
+static constexpr UBaseType_t PRIO_SENSOR         = 5;   // BMP280 reads
+static constexpr UBaseType_t PRIO_CONTROL        = 4;   // NMEA parse, FSM, strobe, BLE work
+static constexpr UBaseType_t PRIO_AUDIO          = 3;   // DFPlayer sequencing
+static constexpr UBaseType_t PRIO_UI             = 2;   // TFT rendering
+static constexpr UBaseType_t PRIO_LOG            = 1;   // deferred log formatting
+static constexpr UBaseType_t PRIO_BLE_INIT       = 1;   // one-shot BLE bring-up at boot
+
+static constexpr uint32_t    STACK_NAV           = 3072;
+static constexpr uint32_t    STACK_SENSOR        = 3072;
+static constexpr uint32_t    STACK_CONTROL       = 8192;
+static constexpr uint32_t    STACK_AUDIO         = 2048;
+static constexpr uint32_t    STACK_UI            = 6144;
+static constexpr uint32_t    STACK_LOG           = 3072;
+static constexpr uint32_t    STACK_BLE_INIT      = 8192;
+
+// ---- Periods ----
+static constexpr uint32_t    NAV_POLL_MS         = 5;     // 38400 baud -> ~20 bytes per poll
+static constexpr uint32_t    CONTROL_PERIOD_MS   = 5;     // upper bound; new NMEA wakes it at once
+static constexpr uint32_t    NAV_POLL_GROUND_MS  = 20;    // PWR_GROUND (app/power.h); ~77 bytes at 38400
+static constexpr uint32_t    CONTROL_PERIOD_GROUND_MS = 50;
+static constexpr uint32_t    AUDIO_PERIOD_MS     = 5;
+static constexpr uint32_t    UI_FRAME_MS         = 160;
+static constexpr uint32_t    LOG_PERIOD_MS       = 20;
+
+// ---- Queue depths (all bounded; producers never block) ----
+static constexpr UBaseType_t NAV_LINE_QUEUE      = 16;
+static constexpr UBaseType_t BARO_QUEUE          = 4;
+static constexpr UBaseType_t KEY_QUEUE           = 16;
+static constexpr UBaseType_t AUDIO_QUEUE         = 16;
+static constexpr size_t      LOG_RING            = 64;    // deferred log records (power of two)
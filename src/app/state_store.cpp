@@ -0,0 +1,80 @@
+#include "state_store.h"
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static HaloState             cur;
+static uint32_t              fieldVer[SF_COUNT] = {0};
+static uint32_t              version = 0;
+static std::atomic<uint32_t> seq{0};   // odd while a commit is in progress
+
+// Floats compare bitwise so NaN == NaN ("still unknown" is not a change)
+static inline bool feq(float a, float b){ return memcmp(&a, &b, sizeof(a)) == 0; }
+
+static bool same_tele(const Telemetry& a, const Telemetry& b){
+  return feq(a.tC, b.tC) && feq(a.p_hPa, b.p_hPa) && feq(a.alt_m, b.alt_m) && a.bmp_ok == b.bmp_ok
+      && feq(a.sog_kts, b.sog_kts) && feq(a.track_deg, b.track_deg)
+      && feq(a.turn_dps, b.turn_dps) && a.track_ms == b.track_ms && a.last_nmea_ms == b.last_nmea_ms
+      && feq(a.vs_ms, b.vs_ms) && a.utc_hour == b.utc_hour && a.utc_min == b.utc_min
+      && a.utc_epoch == b.utc_epoch
+      && a.lat_e7 == b.lat_e7 && a.lon_e7 == b.lon_e7 && a.pos_ms == b.pos_ms;
+}
+static bool same_alert(const TrafficAlert& a, const TrafficAlert& b){
+  return a.active == b.active && a.since == b.since && a.alarm == b.alarm && a.id == b.id && a.rx_us == b.rx_us
+      && feq(a.relN_m, b.relN_m) && feq(a.relE_m, b.relE_m) && feq(a.relV_m, b.relV_m)
+      && feq(a.dist_m, b.dist_m) && feq(a.bearing_deg, b.bearing_deg)
+      && feq(a.vN_ms, b.vN_ms) && feq(a.vE_ms, b.vE_ms) && feq(a.vV_ms, b.vV_ms)
+      && feq(a.tcpa_s, b.tcpa_s) && feq(a.cpa_m, b.cpa_m);
+}
+
+static uint32_t diff(const HaloState& a, const HaloState& b){
+  uint32_t m = 0;
+  if (!same_tele(a.tele, b.tele))                                              m |= SM_TELE;
+  if (!same_alert(a.alert, b.alert))                                           m |= SM_ALERT;
+  if (a.baselineSet != b.baselineSet || !feq(a.baselineAlt_m, b.baselineAlt_m)) m |= SM_BASELINE;
+  if (!feq(a.qnh_hPa, b.qnh_hPa) || !feq(a.elev_ft, b.elev_ft) || a.volume != b.volume) m |= SM_CONFIG;
+  if (a.state != b.state || a.strobe_level != b.strobe_level || a.strobe_on != b.strobe_on) m |= SM_FSM;
+  if (a.nav_ok != b.nav_ok)                                                    m |= SM_NAV;
+  if (a.page != b.page || a.redraw != b.redraw)                                m |= SM_UI;
+  if (a.flight_ms != b.flight_ms || a.flight_alerts != b.flight_alerts)        m |= SM_FLIGHT;
+  return m;
+}
+
+uint32_t state_commit(const HaloState& next){
+  const uint32_t mask = version ? diff(cur, next) : SM_ALL;
+  if (!mask) return 0;
+
+  const uint32_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  cur = next;
+  version++;
+  for (uint8_t i=0; i<SF_COUNT; ++i) if (mask & (1u << i)) fieldVer[i] = version;
+
+  seq.store(s + 2, std::memory_order_release);
+  return mask;
+}
+
+uint32_t state_read(HaloState& out, uint32_t& seen){
+  uint32_t ver, fv[SF_COUNT];
+  for (uint32_t spins = 0; ; ++spins) {
+    const uint32_t s1 = seq.load(std::memory_order_acquire);
+    if (s1 & 1) {
+      if (spins > 64) vTaskDelay(1);   // writer preempted mid-commit on this core
+      continue;
+    }
+    out = cur;
+    ver = version;
+    memcpy(fv, fieldVer, sizeof(fv));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq.load(std::memory_order_relaxed) == s1) break;
+  }
+
+  uint32_t mask = 0;
+  if (seen == 0) mask = SM_ALL;
+  else for (uint8_t i=0; i<SF_COUNT; ++i) if (fv[i] > seen) mask |= 1u << i;
+  seen = ver;
+  return mask;
+}
+
@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include "telemetry.h"
+#include "app_fsm.h"
+#include "ui_iface.h"
+
+// Central published state. The control task is the single writer: it commits a
+// full copy once per tick and the store works out which field groups changed.
+// Readers on any task get a coherent copy without locks (seqlock) plus a mask
+// of the groups that changed since the version they last saw.
+struct HaloState {
+  Telemetry    tele;
+  TrafficAlert alert;
+  bool         baselineSet   = false;   // SM_BASELINE
+  float        baselineAlt_m = NAN;
+  float        qnh_hPa       = 1013.25f; // SM_CONFIG
+  float        elev_ft       = 0.0f;
+  uint8_t      volume        = 24;
+  AppState     state         = ST_BOOT;  // SM_FSM
+  uint8_t      strobe_level  = 0;
+  bool         strobe_on     = false;
+  bool         nav_ok        = false;    // SM_NAV
+  Page         page          = PAGE_BOOT; // SM_UI
+  uint32_t     redraw        = 0;         // bumped by ui_set_page / ui_markAllUndrawn
+  uint32_t     flight_ms     = 0;         // SM_FLIGHT (last landed flight)
+  uint16_t     flight_alerts = 0;
+};
+
+enum StateField : uint8_t {
+  SF_TELE, SF_ALERT, SF_BASELINE, SF_CONFIG, SF_FSM, SF_NAV, SF_UI, SF_FLIGHT, SF_COUNT
+};
+enum : uint32_t {
+  SM_TELE     = 1u << SF_TELE,
+  SM_ALERT    = 1u << SF_ALERT,
+  SM_BASELINE = 1u << SF_BASELINE,
+  SM_CONFIG   = 1u << SF_CONFIG,
+  SM_FSM      = 1u << SF_FSM,
+  SM_NAV      = 1u << SF_NAV,
+  SM_UI       = 1u << SF_UI,
+  SM_FLIGHT   = 1u << SF_FLIGHT,
+  SM_ALL      = (1u << SF_COUNT) - 1
+};
+
+// Writer (control task only). Returns the mask committed (0 = nothing changed, no new version).
+uint32_t state_commit(const HaloState& next);
+
+// Any task. Copies the latest state into out and returns the groups changed
+// since `seen` (SM_ALL when seen == 0); `seen` is advanced to the copy's version.
+uint32_t state_read(HaloState& out, uint32_t& seen);
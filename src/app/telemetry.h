@@ -9,7 +9,13 @@ struct Telemetry {
   bool  bmp_ok    = false;
 
   float sog_kts   = NAN;     // speed over ground (kn)
-  float track_deg = NAN;     // course/track (deg)
+  float track_deg = NAN;     // course/track (deg) at the last RMC
+  float turn_dps  = 0.0f;    // estimated turn rate (deg/s, + = right), nav/heading.h
+  uint32_t track_ms = 0;     // millis() of the last RMC track
+
+  int32_t  lat_e7   = 0;     // position (degrees * 1e7, + = N / E) from RMC/GGA
+  int32_t  lon_e7   = 0;
+  uint32_t pos_ms   = 0;     // millis() of the last valid position, 0 = none yet
 
   uint32_t last_nmea_ms = 0;
   float    vs_ms        = 0.0f;  // vertical speed (m/s), derived
@@ -17,6 +23,9 @@ struct Telemetry {
   // UTC from RMC (HH:MM). -1 means unknown.
   int   utc_hour  = -1;     // 0..23
   int   utc_min   = -1;     // 0..59
+
+  // Full UTC (RMC time + date) as unix seconds at last_nmea_ms. 0 means unknown.
+  uint32_t utc_epoch = 0;
 };
 extern Telemetry tele;
 
@@ -29,7 +38,14 @@ struct TrafficAlert {
   float    relV_m      = 0;     // relative vertical (m)
   float    dist_m      = 0;     // planar distance (m)
   float    bearing_deg = 0;     // absolute bearing (deg)
-  int      alarm       = 0;     // 0..3(+)
+  int      alarm       = 0;     // 0..3 (primary threat, with step-down delay)
+  uint32_t id          = 0;     // (ID type << 24) | FLARM ID of the primary threat (nav/traffic.h)
+  float    vN_ms       = 0;     // relative velocity (m/s) for dead reckoning
+  float    vE_ms       = 0;
+  float    vV_ms       = 0;
+  float    tcpa_s      = -1;    // time to closest approach (s); < 0 when diverging/unknown
+  float    cpa_m       = 0;     // predicted horizontal miss distance (m)
+  uint32_t rx_us       = 0;     // latency trace tag: UART arrival of the source line (0 = untagged)
 };
 extern TrafficAlert alert;
 
@@ -0,0 +1,191 @@
+#include "ble_bulk.h"
+#include "ble_ctrl.h"
+#include "../storage/logbook.h"
+#include "../storage/fdr.h"
+#include "../storage/encounters.h"
+#include "../storage/flash_ring.h"
+#include "../util/hlog.h"
+
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+
+enum : uint8_t { OP_LIST=0x00, OP_OPEN=0x01, OP_ACK=0x02, OP_CLOSE=0x03 };
+enum : uint8_t { NT_DATA=0xD0, NT_INFO=0xE0, NT_EOF=0xE1, NT_ERR=0xEE };
+enum : uint8_t { ERR_SOURCE=1, ERR_FORMAT=2, ERR_MTU=3 };
+
+static const uint8_t  DATA_HDR       = 5;        // op + u32 pos
+static const uint8_t  MAX_WINDOW     = 32;
+static const uint8_t  PKTS_PER_TICK  = 8;        // bound time spent per loop pass
+
+static BLECharacteristic* pBulk = nullptr;
+static BLE2902*           pCccd = nullptr;
+static uint16_t           mtu    = 23;
+
+// Requests arrive on the BLE task; the loop consumes them in ble_bulk_tick().
+// Link edges and the MTU are latched the same way.
+static volatile bool     linkUp   = false;
+static volatile bool     reqReset = false;
+static volatile uint16_t reqMtu   = 23;
+static volatile bool     reqList  = false;
+static uint8_t           listNext = 0;          // next source to LIST; 0 = none pending
+static volatile bool     reqOpen  = false;
+static volatile bool     reqClose = false;
+static volatile bool     reqBad   = false;
+static volatile uint8_t  reqSrc   = 0;
+static volatile uint32_t reqPos   = 0;
+static volatile uint8_t  reqWin   = 8;
+static volatile uint32_t ackedPos = 0;
+
+// Active transfer (loop-owned)
+static uint8_t  src     = 0;
+static uint32_t sendPos = 0;
+static uint8_t  window  = 8;
+static bool     eofSent = false;
+
+static uint8_t  pkt[HALO_BLE_MTU];
+
+static inline void put_u32(uint8_t* p, uint32_t v){ p[0]=v; p[1]=v>>8; p[2]=v>>16; p[3]=v>>24; }
+static inline uint32_t get_u32(const uint8_t* p){ return p[0] | (p[1]<<8) | ((uint32_t)p[2]<<16) | ((uint32_t)p[3]<<24); }
+
+// The stream calls never wait on a ring's lock: a writer may hold it through a
+// sector erase, and this runs on the control task. Busy means retry next tick.
+enum RangeResult : uint8_t { RANGE_OK, RANGE_BUSY, RANGE_NO_SRC };
+
+static RangeResult src_range(uint8_t s, uint32_t& begin, uint32_t& end, uint16_t& slot){
+  bool ok;
+  switch (s) {
+    case BULK_SRC_LOGBOOK: ok = logbook_stream_range(begin, end); slot = 32;  break;
+    case BULK_SRC_FDR:     ok = fdr_stream_range(begin, end);     slot = 256; break;
+    case BULK_SRC_ENCOUNTERS: ok = encounters_stream_range(begin, end); slot = 32; break;
+    default: return RANGE_NO_SRC;
+  }
+  return ok ? RANGE_OK : RANGE_BUSY;
+}
+static size_t src_read(uint8_t s, uint32_t& pos, uint8_t* dst, size_t len){
+  switch (s) {
+    case BULK_SRC_LOGBOOK: return logbook_stream_read(pos, dst, len);
+    case BULK_SRC_FDR:     return fdr_stream_read(pos, dst, len);
+    case BULK_SRC_ENCOUNTERS: return encounters_stream_read(pos, dst, len);
+    default: return 0;
+  }
+}
+
+static void send(const uint8_t* p, size_t n){
+  pBulk->setValue((uint8_t*)p, n);
+  pBulk->notify();
+}
+static void send_err(uint8_t code){ uint8_t b[2] = { NT_ERR, code }; send(b, 2); }
+
+static void send_info(uint8_t s, uint32_t begin, uint32_t end, uint16_t slot){
+  uint8_t b[12] = { NT_INFO, s };
+  put_u32(&b[2], begin); put_u32(&b[6], end);
+  b[10] = (uint8_t)slot; b[11] = (uint8_t)(slot >> 8);
+  send(b, sizeof(b));
+}
+
+class BulkCallbacks : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic* c) override {
+    std::string v = c->getValue();
+    if (v.empty()) return;
+    const uint8_t* b = (const uint8_t*)v.data();
+    switch (b[0]) {
+      case OP_LIST:  reqList = true; break;
+      case OP_OPEN:
+        if (v.size() < 7) { reqBad = true; break; }
+        reqSrc = b[1];
+        reqPos = get_u32(&b[2]);
+        reqWin = b[6] ? min<uint8_t>(b[6], MAX_WINDOW) : 8;
+        reqOpen = true;
+        break;
+      case OP_ACK:
+        if (v.size() >= 5) { uint32_t p = get_u32(&b[1]); if (p > ackedPos) ackedPos = p; }
+        break;
+      case OP_CLOSE: reqClose = true; break;
+      default: break;
+    }
+  }
+};
+
+void ble_bulk_attach(BLEService* svc){
+  pBulk = svc->createCharacteristic(BULK_CHARACTERISTIC_UUID,
+                                    BLECharacteristic::PROPERTY_WRITE |
+                                    BLECharacteristic::PROPERTY_WRITE_NR |
+                                    BLECharacteristic::PROPERTY_NOTIFY);
+  pCccd = new BLE2902();
+  pBulk->addDescriptor(pCccd);
+  static BulkCallbacks cb;
+  pBulk->setCallbacks(&cb);
+}
+
+static void end_transfer(){
+  if (src) ble_link_boost(false);
+  src = 0;
+}
+
+void ble_bulk_link(bool connected){
+  linkUp = connected;
+  if (!connected) { reqMtu = 23; reqOpen = reqList = reqClose = reqBad = false; reqReset = true; }
+}
+
+void ble_bulk_set_mtu(uint16_t m){ reqMtu = min<uint16_t>(m, HALO_BLE_MTU); }
+
+bool ble_bulk_active(){ return src != 0; }
+
+void ble_bulk_tick(uint32_t){
+  if (reqReset) { reqReset = false; src = 0; listNext = 0; }   // link dropped: no boost to undo
+  if (!pBulk || !linkUp) return;
+  mtu = reqMtu;
+
+  if (reqBad)   { reqBad = false; send_err(ERR_FORMAT); }
+  if (reqClose) { reqClose = false; end_transfer(); }
+  if (reqList)  { reqList = false; listNext = BULK_SRC_LOGBOOK; }
+  while (listNext) {
+    uint32_t begin, end; uint16_t slot;
+    if (src_range(listNext, begin, end, slot) == RANGE_BUSY) break;
+    send_info(listNext, begin, end, slot);
+    listNext = (listNext < BULK_SRC_ENCOUNTERS) ? listNext + 1 : 0;
+  }
+
+  if (reqOpen) {
+    uint32_t begin, end; uint16_t slot;
+    const RangeResult rr = src_range(reqSrc, begin, end, slot);
+    if (rr == RANGE_BUSY) return;               // keep the request; retry next tick
+    reqOpen = false;
+    if (rr == RANGE_NO_SRC)                    { send_err(ERR_SOURCE); return; }
+    if (mtu < 3 + DATA_HDR + 16)               { send_err(ERR_MTU);    return; }
+    if (!src) ble_link_boost(true);           // short interval + 2M PHY while streaming
+    src      = reqSrc;
+    sendPos  = max<uint32_t>((uint32_t)reqPos, begin);
+    ackedPos = sendPos;
+    window   = reqWin;
+    eofSent  = false;
+    send_info(src, begin, end, slot);
+    HLOGI("[BLE] BULK open src=%u pos=%lu win=%u\n", (unsigned)src, (unsigned long)sendPos, (unsigned)window);
+  }
+
+  if (!src || !pCccd->getNotifications()) return;
+
+  const size_t chunk = mtu - 3 - DATA_HDR;
+  for (uint8_t i=0; i<PKTS_PER_TICK; ++i) {
+    // Flow control: stop once `window` packets are unacknowledged
+    if (sendPos > ackedPos && (sendPos - ackedPos) >= (uint32_t)window * chunk) return;
+
+    uint32_t pos = sendPos;
+    size_t n = src_read(src, pos, &pkt[DATA_HDR], chunk);   // flash -> notification buffer
+    if (n == FRING_BUSY) return;
+    if (n == 0) {
+      if (!eofSent) {
+        uint8_t b[6] = { NT_EOF, src }; put_u32(&b[2], pos);
+        send(b, sizeof(b));
+        eofSent = true;
+      }
+      if (ackedPos >= pos) { HLOGI("[BLE] BULK complete\n"); end_transfer(); }
+      return;
+    }
+    pkt[0] = NT_DATA;
+    put_u32(&pkt[1], pos);
+    send(pkt, DATA_HDR + n);
+    sendPos = pos + n;
+  }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+class BLEService;
+
+// Bulk log download over one write+notify characteristic.
+//
+// Client -> device (write):
+//   [0x00]                                  LIST   -> one INFO per source
+//   [0x01][src][u32 pos][u8 window]         OPEN   stream src from absolute pos
+//   [0x02][u32 pos]                         ACK    everything below pos received
+//   [0x03]                                  CLOSE
+// Device -> client (notify):
+//   [0xD0][u32 pos][bytes...]               DATA   raw flash slots (seq/crc headers included)
+//   [0xE0][src][u32 begin][u32 end][u16 slot]  INFO  available range
+//   [0xE1][src][u32 end]                    EOF
+//   [0xEE][code]                            ERROR
+// At most `window` DATA packets are in flight beyond the last ACK; a transfer
+// resumes from any earlier position by re-sending OPEN.
+enum BulkSource : uint8_t {
+  BULK_SRC_LOGBOOK = 1,
+  BULK_SRC_FDR     = 2,
+  BULK_SRC_ENCOUNTERS = 3,
+};
+
+void ble_bulk_attach(BLEService* svc);
+void ble_bulk_link(bool connected);
+void ble_bulk_set_mtu(uint16_t mtu);
+void ble_bulk_tick(uint32_t now);
+bool ble_bulk_active();
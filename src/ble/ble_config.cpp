@@ -0,0 +1,129 @@
+#include "ble_config.h"
+#include "ble_ctrl.h"
+#include "../util/spsc_queue.h"
+#include "../util/hlog.h"
+
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+
+enum : uint8_t { T_QNH=0x01, T_ELEV=0x02, T_VOLUME=0x03, T_SOURCE=0x04, T_BAUD=0x05 };
+
+struct CfgRequest {
+  HaloConfig cfg;
+  uint8_t    status;
+  uint8_t    bad_tag;
+};
+
+static BLECharacteristic*       pConfig = nullptr;
+static SpscQueue<CfgRequest, 4> reqQueue;
+static volatile bool            reqDropped = false;
+
+static inline uint16_t get_u16(const uint8_t* p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+
+// One validation pass over the whole write; fills `out` only with checked values
+static uint8_t decode(const uint8_t* p, size_t n, HaloConfig& out, uint8_t& bad){
+  size_t i = 0;
+  while (i < n) {
+    if (i + 2 > n) { bad = p[i]; return CFG_ERR_LENGTH; }
+    const uint8_t tag = p[i], len = p[i+1];
+    const uint8_t* v = &p[i+2];
+    bad = tag;
+    if (i + 2 + len > n) return CFG_ERR_LENGTH;
+
+    switch (tag) {
+      case T_QNH:
+        if (len != 2) return CFG_ERR_LENGTH;
+        out.qnh_dhPa = get_u16(v);
+        if (out.qnh_dhPa < 8000 || out.qnh_dhPa > 12000) return CFG_ERR_RANGE;
+        out.mask |= CFG_QNH;
+        break;
+      case T_ELEV:
+        if (len != 2) return CFG_ERR_LENGTH;
+        out.elev_ft = get_u16(v);
+        if (out.elev_ft > 30000) return CFG_ERR_RANGE;
+        out.mask |= CFG_ELEV;
+        break;
+      case T_VOLUME:
+        if (len != 1) return CFG_ERR_LENGTH;
+        if (v[0] > 30) return CFG_ERR_RANGE;
+        out.volume = v[0]; out.mask |= CFG_VOLUME;
+        break;
+      case T_SOURCE:
+        if (len != 1) return CFG_ERR_LENGTH;
+        if (v[0] > 1) return CFG_ERR_RANGE;
+        out.source = v[0]; out.mask |= CFG_SOURCE;
+        break;
+      case T_BAUD:
+        if (len != 1) return CFG_ERR_LENGTH;
+        if (v[0] > 1) return CFG_ERR_RANGE;
+        out.baud_idx = v[0]; out.mask |= CFG_BAUD;
+        break;
+      default:
+        return CFG_ERR_TAG;
+    }
+    i += 2 + len;
+  }
+  bad = 0;
+  return CFG_OK;
+}
+
+static size_t encode(const HaloConfig& c, uint8_t status, uint8_t bad, uint8_t* p){
+  size_t n = 0;
+  p[n++] = status; p[n++] = bad;
+  p[n++] = T_QNH;    p[n++] = 2; p[n++] = (uint8_t)c.qnh_dhPa; p[n++] = (uint8_t)(c.qnh_dhPa >> 8);
+  p[n++] = T_ELEV;   p[n++] = 2; p[n++] = (uint8_t)c.elev_ft;  p[n++] = (uint8_t)(c.elev_ft >> 8);
+  p[n++] = T_VOLUME; p[n++] = 1; p[n++] = c.volume;
+  p[n++] = T_SOURCE; p[n++] = 1; p[n++] = c.source;
+  p[n++] = T_BAUD;   p[n++] = 1; p[n++] = c.baud_idx;
+  return n;
+}
+
+static void publish(uint8_t status, uint8_t bad, bool notify){
+  HaloConfig cur; halo_get_config(cur);
+  uint8_t buf[24];
+  size_t n = encode(cur, status, bad, buf);
+  pConfig->setValue(buf, n);
+  if (notify) pConfig->notify();
+}
+
+class ConfigCallbacks : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic* c) override {
+    std::string v = c->getValue();
+    CfgRequest r;
+    r.bad_tag = 0;
+    r.status  = decode((const uint8_t*)v.data(), v.size(), r.cfg, r.bad_tag);
+    if (!reqQueue.push(r)) reqDropped = true;
+  }
+};
+
+void ble_config_attach(BLEService* svc){
+  pConfig = svc->createCharacteristic(CONFIG_CHARACTERISTIC_UUID,
+                                      BLECharacteristic::PROPERTY_READ |
+                                      BLECharacteristic::PROPERTY_WRITE |
+                                      BLECharacteristic::PROPERTY_NOTIFY);
+  pConfig->addDescriptor(new BLE2902());
+  static ConfigCallbacks cb;
+  pConfig->setCallbacks(&cb);
+  publish(CFG_OK, 0, false);
+}
+
+void ble_config_tick(uint32_t){
+  if (!pConfig) return;
+
+  CfgRequest r;
+  while (reqQueue.pop(r)) {
+    if (r.status == CFG_OK && r.cfg.mask) {
+      halo_apply_config(r.cfg);
+      HaloConfig cur; halo_get_config(cur);
+      ble_ctrl_sync(cur);
+    } else if (r.status != CFG_OK) {
+      HLOGI("[BLE] CONFIG rejected status=%u tag=0x%02X\n", (unsigned)r.status, (unsigned)r.bad_tag);
+    }
+    publish(r.status, r.bad_tag, true);
+  }
+  if (reqDropped) {
+    reqDropped = false;
+    publish(CFG_ERR_BUSY, 0, true);
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+class BLEService;
+
+// Batched configuration: one read/write/notify characteristic carrying TLVs.
+//
+// Write:  [tag][len][value]...   (any subset, little-endian values)
+//   0x01 QNH      u16  0.1 hPa (8000..12000)
+//   0x02 ELEV     u16  feet (0..30000)
+//   0x03 VOLUME   u8   0..30
+//   0x04 SOURCE   u8   0=FLARM, 1=SoftRF
+//   0x05 BAUD     u8   0=19200, 1=38400
+// The whole write is validated first; nothing is applied if any TLV is bad.
+// Accepted writes are applied together and persisted with a single NVS commit.
+//
+// Read / notify after each write:  [status][bad tag][full TLV set]
+//   status: 0=OK, 1=bad length, 2=out of range, 3=unknown tag, 4=busy
+enum : uint8_t {
+  CFG_OK = 0, CFG_ERR_LENGTH = 1, CFG_ERR_RANGE = 2, CFG_ERR_TAG = 3, CFG_ERR_BUSY = 4
+};
+
+void ble_config_attach(BLEService* svc);   // create characteristic (during BLE init)
+void ble_config_tick(uint32_t now);        // call from bleTick(); applies queued writes
@@ -8,17 +8,24 @@
 #include <BLE2902.h>
 
 #include "ble_ctrl.h"          // UUIDs + app hooks
+#include "ble_live.h"          // live telemetry notify stream
+#include "ble_bulk.h"          // bulk log download
+#include "ble_config.h"        // batched TLV configuration
+#include "ble_prof.h"          // profiler readout
+#include "ble_nmea.h"          // NMEA bridge (Nordic UART service)
 
 #include "../drivers/dfplayer.h"
 #include "../app/telemetry.h"
 #include "../app/ui_iface.h"
 #include "../app/app_fsm.h"
 #include "../app/constants.h"
+#include "../app/prompts.h"
+#include "../util/spsc_queue.h"
+#include "../util/prof.h"
+#include "../util/hlog.h"
+#include "../util/fixed_trig.h"
 
 // ---- HALO globals owned by main/app (runtime mirrors) ----
-extern float   qnh_hPa;
-extern float   airfieldElev_ft;
-extern uint8_t df_volume;
 extern void    strobeEnable(bool);
 extern void    strobeSet(uint16_t on_ms, uint16_t period_ms);
 
@@ -34,6 +41,10 @@ static BLECharacteristic
   *pResetCharacteristic      = nullptr,
   *pDataSourceCharacteristic = nullptr;
 
+// ===== Connected peer (single central) =====
+static esp_bd_addr_t peerBda   = {0};
+static bool          peerValid = false;
+
 // ===== Runtime mirrors for BLE reads =====
 static uint8_t  curVolume = 24;         // 0..30
 static uint16_t curElevationFeet = 0;   // feet (uint16)
@@ -48,18 +59,31 @@ static uint8_t  testSequenceStep = 0;
 static uint32_t lastTestStepTime = 0;
 static const uint32_t TEST_STEP_MS = 6000; // more headroom for audio
 
-// ---------- small utils ----------
-static inline void dbg(const char* s){ Serial.println(s); }
-static void log_payload(const char* tag, const std::string& v){
-  Serial.printf("[BLE] %s len=%u ascii='", tag, (unsigned)v.size());
-  for (size_t i=0;i<v.size();++i) {
-    char c = (char)v[i];
-    Serial.printf("%c", (c>=32 && c<=126)?c:'.');
-  }
-  Serial.printf("' hex=");
-  for (size_t i=0;i<v.size();++i) Serial.printf("%02X ", (uint8_t)v[i]);
-  Serial.println();
+// ===== Command queue (BLE host task -> loop) =====
+// Writes are decoded in the BLE callback and executed by bleTick(), so the BLE
+// stack never blocks on flash/UART/audio and app state is only touched by the loop.
+enum BleCmdKind : uint8_t {
+  CMD_FLASH, CMD_TEST, CMD_VOLUME, CMD_ELEV, CMD_QNH, CMD_RESET, CMD_DATASRC
+};
+static const uint8_t KEEP = 0xFF;        // DATASRC: keep current source / baud index
+
+struct BleCmd {
+  BleCmdKind kind;
+  uint8_t    a;        // TEST: start; VOLUME: 0..30; DATASRC: source (or KEEP)
+  uint8_t    b;        // DATASRC: baud index (or KEEP)
+  uint16_t   u16;      // ELEV: feet; QNH: hPa
+};
+
+static SpscQueue<BleCmd, 16> cmdQueue;
+static volatile uint16_t     cmdDropped = 0;
+static uint32_t              flashOffAt = 0;   // FLASH pulse end (0 = idle)
+
+static void post(const BleCmd& cmd){
+  if (!cmdQueue.push(cmd)) cmdDropped++;
 }
+
+// ---------- small utils ----------
+#define dbg(s) HLOGI("%s\n", s)   // s: literal
 static bool is_ascii_digits(const std::string& s){
   if (s.empty()) return false;
   for (char c : s){ if (c<'0'||c>'9') return false; }
@@ -73,29 +97,31 @@ static void injectAlert(int level, float bearing_deg, float relV_m) {
   alert.since  = millis();
   alert.alarm  = level;
 
-  float rad = bearing_deg * 3.1415926f / 180.0f;
+  const bam16_t b = bam_from_deg(bearing_deg);
   float dist = 1000.0f;
-  alert.relN_m = dist * cosf(rad);
-  alert.relE_m = dist * sinf(rad);
+  alert.relN_m = (float)q15_mul((int32_t)dist, icos(b));
+  alert.relE_m = (float)q15_mul((int32_t)dist, isin(b));
   alert.relV_m = relV_m;
   alert.dist_m = hypotf(alert.relN_m, alert.relE_m);
   alert.bearing_deg = bearing_deg;
+  alert.id     = 0;
+  alert.vN_ms  = alert.vE_ms = alert.vV_ms = 0.0f;   // stationary: no dead reckoning
+  alert.tcpa_s = -1.0f; alert.cpa_m = dist;
+  alert.rx_us  = prof_trace_now();        // trace the injected alert like a PFLAA line
 
   ui_set_page(PAGE_TRAFFIC);
 }
 
 static void speakVerticalAndClock(int oclock, const char* vert) {
-  uint16_t vtrk = 10; // LEVEL
-  if (!strcmp(vert,"HIGH")) vtrk = 11;
-  else if (!strcmp(vert,"LOW"))  vtrk = 12;
+  uint16_t vtrk = prompt_track(PROMPT_LEVEL);
+  if (!strcmp(vert,"HIGH")) vtrk = prompt_track(PROMPT_HIGH);
+  else if (!strcmp(vert,"LOW"))  vtrk = prompt_track(PROMPT_LOW);
 
-  int oc = oclock; if (oc < 1 || oc > 12) oc = 12;
-  uint16_t clockTrack = 20 + oc; // 1..12 -> 21..32
+  uint16_t clockTrack = prompt_clock_track(oclock);
 
+  // dfplayer paces queued tracks itself (STOP gap + BUSY edge)
   dfp_stop_and_flush();
-  delay(60);
-  dfp_play_filename(vtrk);
-  delay(140);
+  dfp_play_filename(vtrk, alert.rx_us);
   dfp_play_filename(clockTrack);
 }
 
@@ -149,45 +175,163 @@ static void applyBaudFromIndices() {
   const uint8_t idx = curIsSoftRF ? curBaudIdxSoft : curBaudIdxFlarm;
   const uint32_t baud = (idx == 0) ? 19200UL : 38400UL;
   halo_apply_nav_baud(baud);
-  Serial.printf("[BLE] UART set: %s @ %lu\n",
+  HLOGI("[BLE] UART set: %s @ %lu\n",
     curIsSoftRF ? "SoftRF" : "FLARM", (unsigned long)baud);
 }
 
 // --- BLE callbacks ---
 class MyServerCallbacks : public BLEServerCallbacks {
-  void onConnect(BLEServer*) override { Serial.println("[BLE] client connected"); }
+  void onConnect(BLEServer* s, esp_ble_gatts_cb_param_t* param) override {
+    HLOGI("[BLE] client connected\n");
+    memcpy(peerBda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+    peerValid = true;
+    ble_live_link(true);
+    ble_bulk_link(true);
+    ble_nmea_link(true);
+    ble_live_set_interval((uint16_t)(param->connect.conn_params.interval * 5u / 4u));
+    // Ask for a short interval so batched notifications leave promptly
+    s->updateConnParams(param->connect.remote_bda,
+                        HALO_CONN_MIN_INTERVAL, HALO_CONN_MAX_INTERVAL,
+                        HALO_CONN_LATENCY, HALO_CONN_TIMEOUT);
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+    // Prefer the 2M PHY where both ends support BLE 5
+    esp_ble_gap_set_preferred_phy(param->connect.remote_bda, ESP_BLE_GAP_PHY_OPTIONS_NO_PREF,
+                                  ESP_BLE_GAP_PHY_2M_PREF_MASK, ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                  ESP_BLE_GAP_PHY_OPTIONS_NO_PREF);
+#endif
+  }
   void onDisconnect(BLEServer*) override {
-    Serial.println("[BLE] client disconnected");
+    HLOGI("[BLE] client disconnected\n");
+    peerValid = false;
+    ble_live_link(false);
+    ble_bulk_link(false);
+    ble_nmea_link(false);
     pServer->getAdvertising()->start();
   }
+  void onMtuChanged(BLEServer*, esp_ble_gatts_cb_param_t* param) override {
+    ble_live_set_mtu(param->mtu.mtu);
+    ble_bulk_set_mtu(param->mtu.mtu);
+    ble_nmea_set_mtu(param->mtu.mtu);
+  }
 };
 
-class MyCharCallbacks : public BLECharacteristicCallbacks {
-  void onWrite(BLECharacteristic* c) override {
-    std::string v = c->getValue();
+void ble_link_boost(bool on){
+  if (!pServer || !peerValid) return;
+  if (on) pServer->updateConnParams(peerBda, HALO_BULK_MIN_INTERVAL, HALO_BULK_MAX_INTERVAL,
+                                    HALO_CONN_LATENCY, HALO_CONN_TIMEOUT);
+  else    pServer->updateConnParams(peerBda, HALO_CONN_MIN_INTERVAL, HALO_CONN_MAX_INTERVAL,
+                                    HALO_CONN_LATENCY, HALO_CONN_TIMEOUT);
+}
+
+// Track the interval the central actually granted after our update request
+static void gapHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param){
+  if (event == ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT && param->update_conn_params.status == ESP_BT_STATUS_SUCCESS) {
+    uint16_t ms = (uint16_t)(param->update_conn_params.conn_int * 5u / 4u);
+    ble_live_set_interval(ms);
+    HLOGI("[BLE] conn interval %u ms\n", (unsigned)ms);
+  }
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+  if (event == ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT && param->phy_update.status == ESP_BT_STATUS_SUCCESS) {
+    HLOGI("[BLE] PHY tx=%u rx=%u\n", (unsigned)param->phy_update.tx_phy, (unsigned)param->phy_update.rx_phy);
+  }
+#endif
+}
 
-    if (c == pFlashCharacteristic) {
-      Serial.println("[BLE] FLASH");
+// ---- Payload decoding (runs on the BLE task; pure, no side effects) ----
+static uint8_t parse_volume(const std::string& v){
+  uint16_t u16 = 0;
+  if (v.size()==1) u16 = (uint8_t)v[0];
+  else if (is_ascii_digits(v)) {
+    char buf[8]={0}; size_t n=min(v.size(), sizeof(buf)-1); memcpy(buf,v.data(),n);
+    u16 = (uint16_t)strtoul(buf,nullptr,10);
+  } else if (v.size()>=2) {
+    u16 = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
+  }
+  return (uint8_t)constrain((int)u16, 0, 30);
+}
+
+static uint16_t parse_elevation(const std::string& v){
+  uint16_t feet = 0;
+  if (v.size()==1) {
+    // Single raw byte = tens-of-feet (0x39=57 -> 570 ft)
+    feet = (uint16_t)((uint8_t)v[0]) * 10u;
+  } else if (is_ascii_digits(v)) {
+    // ASCII "570" => 570 ft; "57" => 570 ft (treat <400 as tens)
+    char buf[12]={0}; size_t n=min(v.size(), sizeof(buf)-1); memcpy(buf,v.data(),n);
+    unsigned long val = strtoul(buf,nullptr,10);
+    feet = (val < 400) ? (uint16_t)(val * 10u) : (uint16_t)val;
+  } else if (v.size()>=2) {
+    // LE u16: if small, assume tens
+    uint16_t u = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
+    feet = (u < 400) ? (uint16_t)(u * 10u) : u;
+  }
+  return (uint16_t)constrain((int)feet, 0, 30000);
+}
+
+static uint16_t parse_qnh(const std::string& v){
+  uint16_t hpa = 1013;
+  const bool has_dot = v.find('.') != std::string::npos;
+
+  if (v.size() == 1) {
+    // Slider index: 0..200 => 800..1200 hPa in 2 hPa steps
+    hpa = (uint16_t)(800 + (uint16_t)(uint8_t)v[0] * 2u);
+  } else if (is_ascii_digits(v) || has_dot) {
+    // ASCII "1016" (hPa) or "101.6" (×10)
+    char buf[16] = {0};
+    size_t n = min(v.size(), sizeof(buf)-1);
+    memcpy(buf, v.data(), n);
+    if (has_dot) hpa = (uint16_t)lroundf(strtof(buf, nullptr) * 10.0f);
+    else         hpa = (uint16_t)strtoul(buf, nullptr, 10);
+  } else if (v.size() >= 2) {
+    // LE u16 fallback: if clearly a slider index (< 400), map it; else assume hPa
+    uint16_t u = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
+    hpa = (u < 400) ? (uint16_t)(800 + u * 2u) : u;
+  }
+  if (hpa < 800) hpa = 800;
+  if (hpa > 1200) hpa = 1200;
+  return hpa;
+}
+
+// Data source semantics:
+//  - 1 byte: *baud index only* for the current source (0=19200,1=38400)
+//  - ASCII "FLARM"/"SOFTRF": change source, keep current baud index
+//  - 2 bytes: [source, idx] -> explicit source & baud index
+static bool parse_datasource(const std::string& v, uint8_t& src, uint8_t& idx){
+  src = KEEP; idx = KEEP;
+  if (v == std::string("FLARM"))  { src = 0; return true; }
+  if (v == std::string("SOFTRF")) { src = 1; return true; }
+  if (v.size() >= 2) {
+    src = ((uint8_t)v[0]) != 0;
+    idx = ((uint8_t)v[1] > 1) ? 1 : (uint8_t)v[1];
+    return true;
+  }
+  if (v.size() == 1) {
+    uint8_t b = (v[0] >= '0' && v[0] <= '9') ? (uint8_t)(v[0]-'0') : (uint8_t)v[0];
+    idx = (b > 1) ? 1 : b;
+    return true;
+  }
+  return false;
+}
+
+// ---- Command execution (loop context) ----
+static void execCommand(const BleCmd& cmd, uint32_t now){
+  switch (cmd.kind) {
+    case CMD_FLASH:
+      HLOGI("[BLE] FLASH\n");
       strobeEnable(true);
       strobeSet(STROBE_ON_MS, 250);
-      delay(150);
-      strobeEnable(false);
-      return;
-    }
-
-    if (c == pTestCharacteristic) {
-      log_payload("TEST write", v);
-      bool start = true;
-      if (v.size() >= 1 && (uint8_t)v[0] == 0x00) start = false;
+      flashOffAt = (now + 150) | 1;           // non-zero
+      break;
 
-      if (start) {
+    case CMD_TEST:
+      if (cmd.a) {
         testActive = true;
         testSequenceStep = 0;
         lastTestStepTime = 0;
-        Serial.println("[BLE] TEST sequence START");
+        HLOGI("[BLE] TEST sequence START\n");
       } else {
         testActive = false;
-        Serial.println("[BLE] TEST sequence STOP -> return to BOOT");
+        HLOGI("[BLE] TEST sequence STOP -> return to BOOT\n");
         extern TrafficAlert alert; alert = {};
         dfp_stop_and_flush();
         strobeEnable(false);
@@ -195,142 +339,84 @@ class MyCharCallbacks : public BLECharacteristicCallbacks {
         ui_markAllUndrawn();
         ui_set_page(PAGE_BOOT);
       }
-      uint8_t state = testActive ? 1 : 0;
-      pTestCharacteristic->setValue(&state, 1);
-      return;
-    }
+      { uint8_t state = testActive ? 1 : 0; pTestCharacteristic->setValue(&state, 1); }
+      break;
 
-    if (c == pVolumeCharacteristic) {
-      log_payload("VOLUME write", v);
-      uint16_t u16 = 0;
-      if (v.size()==1) u16 = (uint8_t)v[0];
-      else if (is_ascii_digits(v)) {
-        char buf[8]={0}; size_t n=min(v.size(), sizeof(buf)-1); memcpy(buf,v.data(),n);
-        u16 = (uint16_t)strtoul(buf,nullptr,10);
-      } else if (v.size()>=2) {
-        u16 = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
-      }
-      uint8_t vol = (uint8_t)constrain((int)u16, 0, 30);
-      curVolume = vol;
-      halo_set_volume_runtime_and_persist(vol);
+    case CMD_VOLUME:
+      curVolume = cmd.a;
+      halo_set_volume_runtime_and_persist(curVolume);
       pVolumeCharacteristic->setValue(&curVolume, 1);
-      Serial.printf("[BLE] VOL=%u (saved)\n", curVolume);
-      return;
-    }
-
-    if (c == pElevationCharacteristic) {
-      log_payload("ELEV write", v);
-      uint16_t feet = 0;
-
-      if (v.size()==1) {
-        // Single raw byte = tens-of-feet (0x39=57 -> 570 ft)
-        feet = (uint16_t)((uint8_t)v[0]) * 10u;
-      } else if (is_ascii_digits(v)) {
-        // ASCII "570" => 570 ft; "57" => 570 ft (treat <400 as tens)
-        char buf[12]={0}; size_t n=min(v.size(), sizeof(buf)-1); memcpy(buf,v.data(),n);
-        unsigned long val = strtoul(buf,nullptr,10);
-        feet = (val < 400) ? (uint16_t)(val * 10u) : (uint16_t)val;
-      } else if (v.size()>=2) {
-        // LE u16: if small, assume tens
-        uint16_t u = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
-        feet = (u < 400) ? (uint16_t)(u * 10u) : u;
-      }
+      HLOGI("[BLE] VOL=%u (saved)\n", curVolume);
+      break;
 
-      feet = (uint16_t)constrain((int)feet, 0, 30000);
-      curElevationFeet = feet;
+    case CMD_ELEV:
+      curElevationFeet = cmd.u16;
       halo_set_elev_runtime_and_persist(curElevationFeet);
-      pElevationCharacteristic->setValue((uint8_t*)&feet, 2);
-      Serial.printf("[BLE] ELEV=%u ft (saved)\n", feet);
-      return;
-    }
-
-    if (c == pQnhCharacteristic) {
-      log_payload("QNH write", v);
-      uint16_t hpa = 1013;
-
-      auto has_dot = [](const std::string& s){ return s.find('.') != std::string::npos; };
-
-      if (v.size() == 1) {
-        // Slider index: 0..200 => 800..1200 hPa in 2 hPa steps
-        uint8_t idx = (uint8_t)v[0];
-        hpa = (uint16_t)(800 + (uint16_t)idx * 2u);
-        Serial.printf("[BLE] QNH from slider idx=%u -> %u hPa\n", idx, hpa);
-      } else if (is_ascii_digits(v) || has_dot(v)) {
-        // ASCII "1016" (hPa) or "101.6" (×10)
-        char buf[16] = {0};
-        size_t n = min(v.size(), sizeof(buf)-1);
-        memcpy(buf, v.data(), n);
-        if (has_dot(v)) {
-          float f = strtof(buf, nullptr);
-          hpa = (uint16_t)lroundf(f * 10.0f);
-        } else {
-          unsigned long val = strtoul(buf, nullptr, 10);
-          hpa = (uint16_t)val;
-        }
-      } else if (v.size() >= 2) {
-        // LE u16 fallback: if clearly a slider index (< 400), map it; else assume hPa
-        uint16_t u = (uint16_t)((uint8_t)v[0] | ((uint16_t)(uint8_t)v[1] << 8));
-        hpa = (u < 400) ? (uint16_t)(800 + u * 2u) : u;
-      }
-
-      if (hpa < 800) hpa = 800;
-      if (hpa > 1200) hpa = 1200;
+      pElevationCharacteristic->setValue((uint8_t*)&curElevationFeet, 2);
+      HLOGI("[BLE] ELEV=%u ft (saved)\n", curElevationFeet);
+      break;
 
-      curQnhHpa = hpa;
+    case CMD_QNH:
+      curQnhHpa = cmd.u16;
       halo_set_qnh_runtime_and_persist(curQnhHpa);
-      pQnhCharacteristic->setValue((uint8_t*)&hpa, 2);
-      Serial.printf("[BLE] QNH=%u hPa (saved)\n", hpa);
-      return;
-    }
+      pQnhCharacteristic->setValue((uint8_t*)&curQnhHpa, 2);
+      HLOGI("[BLE] QNH=%u hPa (saved)\n", curQnhHpa);
+      break;
 
-    if (c == pResetCharacteristic) {
+    case CMD_RESET:
       Serial.println("[BLE] RESET requested");
-      delay(50);
+      Serial.flush();
       esp_restart();
-      return;
-    }
+      break;
 
-    if (c == pDataSourceCharacteristic) {
-      log_payload("DATASRC write", v);
-
-      // New semantics:
-      //  - 1 byte: treat as *baud index only* for the current source (0=19200,1=38400)
-      //  - ASCII "FLARM"/"SOFTRF": change source, keep current per-source baud
-      //  - 2 bytes: [source, idx] -> explicit source & baud index
-      bool    isSoft = curIsSoftRF;
-      uint8_t idx    = curIsSoftRF ? curBaudIdxSoft : curBaudIdxFlarm;
-
-      auto set_and_apply = [&](){
-        curIsSoftRF = isSoft;
-        if (isSoft) curBaudIdxSoft = idx; else curBaudIdxFlarm = idx;
-        halo_set_datasource_and_baud(curIsSoftRF, isSoft ? curBaudIdxSoft : curBaudIdxFlarm);
-        applyBaudFromIndices();
-        uint8_t payload[2] = { (uint8_t)(curIsSoftRF ? 1 : 0),
-                               (uint8_t)(curIsSoftRF ? curBaudIdxSoft : curBaudIdxFlarm) };
-        pDataSourceCharacteristic->setValue(payload, 2);
-        Serial.printf("[BLE] DS=%s idx=%u (saved)\n", curIsSoftRF?"SoftRF":"FLARM", (unsigned)payload[1]);
-      };
+    case CMD_DATASRC: {
+      const uint8_t curIdx = curIsSoftRF ? curBaudIdxSoft : curBaudIdxFlarm;
+      const bool    isSoft = (cmd.a == KEEP) ? curIsSoftRF : (cmd.a != 0);
+      const uint8_t idx    = (cmd.b == KEEP) ? curIdx : cmd.b;
+      curIsSoftRF = isSoft;
+      if (isSoft) curBaudIdxSoft = idx; else curBaudIdxFlarm = idx;
+      halo_set_datasource_and_baud(curIsSoftRF, idx);
+      applyBaudFromIndices();
+      uint8_t payload[2] = { (uint8_t)(curIsSoftRF ? 1 : 0), idx };
+      pDataSourceCharacteristic->setValue(payload, 2);
+      HLOGI("[BLE] DS=%s idx=%u (saved)\n", curIsSoftRF?"SoftRF":"FLARM", (unsigned)idx);
+      break;
+    }
+  }
+}
 
-      // CASE 1: explicit strings switch source
-      if (v == std::string("FLARM"))  { isSoft = false; set_and_apply(); return; }
-      if (v == std::string("SOFTRF")) { isSoft = true;  set_and_apply(); return; }
+static void drainCommands(uint32_t now){
+  BleCmd cmd;
+  while (cmdQueue.pop(cmd)) execCommand(cmd, now);
 
-      // CASE 2: two bytes -> [source, idx]
-      if (v.size() >= 2) {
-        isSoft = ((uint8_t)v[0]) != 0;
-        uint8_t b = (uint8_t)v[1];
-        idx = (b > 1) ? 1 : b;
-        set_and_apply(); return;
-      }
+  if (flashOffAt && (int32_t)(now - flashOffAt) >= 0) {
+    strobeEnable(false);
+    flashOffAt = 0;
+  }
+  if (cmdDropped) {
+    HLOGW("[BLE] %u command(s) dropped (queue full)\n", (unsigned)cmdDropped);
+    cmdDropped = 0;
+  }
+}
 
-      // CASE 3: one byte -> *baud index only* for current source
-      if (v.size() == 1) {
-        uint8_t b = (v[0] >= '0' && v[0] <= '9') ? (uint8_t)(v[0]-'0') : (uint8_t)v[0];
-        idx = (b > 1) ? 1 : b;
-        set_and_apply(); return;
-      }
-      return;
+class MyCharCallbacks : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic* c) override {
+    std::string v = c->getValue();
+    BleCmd cmd = {};
+
+    if      (c == pFlashCharacteristic)     { cmd.kind = CMD_FLASH; }
+    else if (c == pTestCharacteristic)      { cmd.kind = CMD_TEST;   cmd.a = !(v.size() >= 1 && (uint8_t)v[0] == 0x00); }
+    else if (c == pVolumeCharacteristic)    { cmd.kind = CMD_VOLUME; cmd.a = parse_volume(v); }
+    else if (c == pElevationCharacteristic) { cmd.kind = CMD_ELEV;   cmd.u16 = parse_elevation(v); }
+    else if (c == pQnhCharacteristic)       { cmd.kind = CMD_QNH;    cmd.u16 = parse_qnh(v); }
+    else if (c == pResetCharacteristic)     { cmd.kind = CMD_RESET; }
+    else if (c == pDataSourceCharacteristic) {
+      cmd.kind = CMD_DATASRC;
+      if (!parse_datasource(v, cmd.a, cmd.b)) return;
     }
+    else return;
+
+    post(cmd);
   } // onWrite
 
   void onRead(BLECharacteristic* c) override {
@@ -363,10 +449,13 @@ static BLECharacteristic* mkChar(BLEService* s, const char* uuid, uint32_t props
 static void initializeBLE() {
   Serial.println("[BLE] init...");
   BLEDevice::init("HALO Control");
+  BLEDevice::setMTU(HALO_BLE_MTU);           // allow the central to negotiate a large MTU
+  BLEDevice::setCustomGapHandler(gapHandler);
   static MyServerCallbacks scb;
   pServer = BLEDevice::createServer();
   pServer->setCallbacks(&scb);
-  pService = pServer->createService(SERVICE_UUID);
+  // Handle budget: 2 per characteristic + 1 per descriptor + service (default 15 is full)
+  pService = pServer->createService(BLEUUID(SERVICE_UUID), 32);
 
   pFlashCharacteristic      = mkChar(pService, FLASH_CHARACTERISTIC_UUID,     BLECharacteristic::PROPERTY_WRITE);
   pTestCharacteristic       = mkChar(pService, TEST_CHARACTERISTIC_UUID,      BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE);
@@ -375,30 +464,33 @@ static void initializeBLE() {
   pQnhCharacteristic        = mkChar(pService, QNH_CHARACTERISTIC_UUID,       BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE);
   pResetCharacteristic      = mkChar(pService, RESET_CHARACTERISTIC_UUID,     BLECharacteristic::PROPERTY_WRITE);
   pDataSourceCharacteristic = mkChar(pService, DATASOURCE_CHAR_UUID,          BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE);
+  ble_live_attach(pService);
+  ble_bulk_attach(pService);
+  ble_config_attach(pService);
+  ble_prof_attach(pService);
+  ble_nmea_attach(pServer);
 }
 
 static void seedValuesFromRuntime() {
-  curVolume         = df_volume;
-  curElevationFeet  = (uint16_t)max(0.0f, airfieldElev_ft);
-  curQnhHpa         = (uint16_t)max(0.0f, qnh_hPa);
+  HaloConfig cfg; halo_get_config(cfg);
+  ble_ctrl_sync(cfg);
 
-  // Defaults (can be overwritten by NVS restore in main before bleInit())
-  curIsSoftRF       = false;
-  curBaudIdxFlarm   = 0; // 19200
-  curBaudIdxSoft    = 1; // 38400
+  uint8_t st = testActive ? 1 : 0;
+  pTestCharacteristic->setValue(&st, 1);
+}
+
+void ble_ctrl_sync(const HaloConfig& cfg){
+  curVolume        = cfg.volume;
+  curElevationFeet = cfg.elev_ft;
+  curQnhHpa        = (uint16_t)((cfg.qnh_dhPa + 5) / 10);
+  curIsSoftRF      = cfg.source != 0;
+  if (curIsSoftRF) curBaudIdxSoft = cfg.baud_idx; else curBaudIdxFlarm = cfg.baud_idx;
 
   pVolumeCharacteristic->setValue(&curVolume, 1);
   pElevationCharacteristic->setValue((uint8_t*)&curElevationFeet, 2);
   pQnhCharacteristic->setValue((uint8_t*)&curQnhHpa, 2);
-
-  uint8_t payload[2] = {
-    (uint8_t)(curIsSoftRF ? 1 : 0),
-    (uint8_t)(curIsSoftRF ? curBaudIdxSoft : curBaudIdxFlarm)
-  };
+  uint8_t payload[2] = { (uint8_t)(curIsSoftRF ? 1 : 0), cfg.baud_idx };
   pDataSourceCharacteristic->setValue(payload, 2);
-
-  uint8_t st = testActive ? 1 : 0;
-  pTestCharacteristic->setValue(&st, 1);
 }
 
 static void finalizeBLE() {
@@ -408,19 +500,29 @@ static void finalizeBLE() {
 }
 
 // ---- Public API ----
+static volatile bool bleReady = false;   // bleInit() may run while the control task ticks
+
 void bleInit() {
   initializeBLE();
   seedValuesFromRuntime();
   finalizeBLE();
+  bleReady = true;
 }
 
 void bleTick(uint32_t now){
+  if (!bleReady) return;
+  drainCommands(now);
   runTestSequence(now);
+  ble_live_tick(now);
+  ble_bulk_tick(now);
+  ble_config_tick(now);
+  ble_prof_tick(now);
+  ble_nmea_tick(now);
 }
 
 void bleCancelTests(){
   testActive = false;
   testSequenceStep = 0;
   lastTestStepTime = 0;
-  Serial.println("[BLE] TEST sequence cancelled");
+  HLOGI("[BLE] TEST sequence cancelled\n");
 }
@@ -10,6 +10,19 @@
 #define QNH_CHARACTERISTIC_UUID       "b9c2d055-5c6a-4b8a-8c0d-2e1e1c6f4b9d"
 #define RESET_CHARACTERISTIC_UUID     "c8b2d055-5c6a-4b8a-8c0d-2e1e1c6f4b9e"
 #define DATASOURCE_CHAR_UUID          "d8b2d055-5c6a-4b8a-8c0d-2e1e1c6f4b9f"
+#define LIVE_CHARACTERISTIC_UUID      "e9c2d055-5c6a-4b8a-8c0d-2e1e1c6f4ba0"
+#define BULK_CHARACTERISTIC_UUID      "fac2d055-5c6a-4b8a-8c0d-2e1e1c6f4ba1"
+#define CONFIG_CHARACTERISTIC_UUID    "0bd2d055-5c6a-4b8a-8c0d-2e1e1c6f4ba2"
+#define PROFILE_CHARACTERISTIC_UUID   "1cd2d055-5c6a-4b8a-8c0d-2e1e1c6f4ba3"
+
+// Link tuning: large ATT MTU; 30–50 ms connection interval, no latency, 4 s timeout
+#define HALO_BLE_MTU                  247
+#define HALO_CONN_MIN_INTERVAL        24    // x1.25 ms
+#define HALO_CONN_MAX_INTERVAL        40    // x1.25 ms
+#define HALO_CONN_LATENCY             0
+#define HALO_CONN_TIMEOUT             400   // x10 ms
+#define HALO_BULK_MIN_INTERVAL        6     // 7.5 ms while a bulk transfer runs
+#define HALO_BULK_MAX_INTERVAL        12    // 15 ms
 
 // ===== App hooks (implemented in main.cpp) =====
 void halo_set_volume_runtime_and_persist(uint8_t vol0_30);
@@ -18,10 +31,37 @@ void halo_set_elev_runtime_and_persist(uint16_t feet);
 void halo_set_datasource_and_baud(bool isSoftRF, uint8_t baudIndex); // 0=19200, 1=38400
 void halo_apply_nav_baud(uint32_t baud);
 
-// Call once (after splash, when the system is up)
+// Batched configuration (CONFIG characteristic). Only fields whose CFG_* bit is
+// set in mask are applied; halo_get_config() fills every field.
+enum : uint8_t {
+  CFG_QNH    = 1 << 0,
+  CFG_ELEV   = 1 << 1,
+  CFG_VOLUME = 1 << 2,
+  CFG_SOURCE = 1 << 3,
+  CFG_BAUD   = 1 << 4,
+  CFG_ALL    = 0x1F
+};
+struct HaloConfig {
+  uint8_t  mask     = 0;
+  uint16_t qnh_dhPa = 10132;  // 0.1 hPa, 8000..12000
+  uint16_t elev_ft  = 0;      // 0..30000
+  uint8_t  volume   = 24;     // 0..30
+  uint8_t  source   = 0;      // 0=FLARM, 1=SoftRF
+  uint8_t  baud_idx = 0;      // 0=19200, 1=38400
+};
+void halo_get_config(HaloConfig& out);
+void halo_apply_config(const HaloConfig& in);   // caller validates; one NVS commit
+
+// Refresh the per-setting characteristics after a batched change
+void ble_ctrl_sync(const HaloConfig& cfg);
+
+// Link helper for BLE sub-modules: request the fast connection interval (bulk transfer) or relax it
+void ble_link_boost(bool on);
+
+// Call once at boot; main runs it in a background task (bleTick idles until done)
 void bleInit();
 
-// Call every loop with millis()
+// Call from the control task with millis()
 void bleTick(uint32_t now);
 
 // Cancel any running test sequence (call from your 'C' panic)
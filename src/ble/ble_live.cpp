@@ -0,0 +1,131 @@
+#include "ble_live.h"
+#include "ble_ctrl.h"
+#include "../app/live_frame.h"
+#include "../app/state_store.h"
+#include "../util/hlog.h"
+
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+
+// Notification = [u8 version][u8 count][count x HaloLiveFrame]
+static const uint8_t HDR_BYTES  = 2;
+static const uint8_t MAX_BATCH  = 6;                    // 2 + 6*38 = 230 fits a 247 MTU
+
+static BLECharacteristic* pLive   = nullptr;
+static BLE2902*           pCccd   = nullptr;
+
+static volatile uint8_t  rateHz      = LIVE_DEFAULT_HZ;
+static volatile bool     congested   = false;           // set from the BLE task on GATT error
+
+// Link edges, MTU and interval arrive on the BLE task; ble_live_tick() applies them
+static volatile bool     linkUp      = false;
+static volatile bool     reqLink     = false;           // edge pending: restart batching
+static volatile uint16_t reqMtu      = 23;
+static volatile uint16_t reqInterval = 50;
+
+// Applied copies (control task)
+static uint16_t          mtu         = 23;
+static uint16_t          intervalMs  = 50;
+
+static uint8_t  pkt[HDR_BYTES + MAX_BATCH * sizeof(HaloLiveFrame)];
+static uint8_t  nBatched   = 0;
+static uint8_t  batchGoal  = 1;                         // frames per notification right now
+static uint32_t nextSample = 0;
+static bool     mtuWarned  = false;
+
+static inline uint8_t fit_frames(uint16_t m = mtu){
+  int room = (int)m - 3 - HDR_BYTES;                    // ATT notify header is 3 bytes
+  int n = room / (int)sizeof(HaloLiveFrame);
+  return (uint8_t)constrain(n, 0, (int)MAX_BATCH);
+}
+
+// Batch enough samples to cover one connection interval; double on congestion.
+static void recompute_goal(){
+  const uint8_t hz = rateHz;
+  const uint32_t period = hz ? 1000u / hz : 1000u;
+  uint32_t goal = (intervalMs + period - 1) / period;
+  if (congested) goal *= 2;
+  const uint8_t cap = max<uint8_t>(1, fit_frames());
+  batchGoal = (uint8_t)constrain(goal, (uint32_t)1, (uint32_t)cap);
+}
+
+class LiveCallbacks : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic* c) override {
+    std::string v = c->getValue();
+    if (v.empty()) return;
+    uint8_t hz = (uint8_t)v[0];
+    if (hz >= '0' && hz <= '9' && v.size() <= 2) hz = (uint8_t)atoi(v.c_str());  // ASCII convenience
+    rateHz = min<uint8_t>(hz, LIVE_MAX_HZ);
+    HLOGI("[BLE] LIVE rate=%uHz\n", (unsigned)rateHz);
+  }
+  void onStatus(BLECharacteristic*, Status s, uint32_t) override {
+    if (s == Status::ERROR_GATT)         congested = true;
+    else if (s == Status::SUCCESS_NOTIFY) congested = false;
+  }
+};
+
+void ble_live_attach(BLEService* svc){
+  pLive = svc->createCharacteristic(LIVE_CHARACTERISTIC_UUID,
+                                    BLECharacteristic::PROPERTY_READ |
+                                    BLECharacteristic::PROPERTY_WRITE |
+                                    BLECharacteristic::PROPERTY_NOTIFY);
+  pCccd = new BLE2902();
+  pLive->addDescriptor(pCccd);
+  static LiveCallbacks cb;
+  pLive->setCallbacks(&cb);
+}
+
+void ble_live_link(bool connected){
+  congested = false;
+  if (!connected) { reqMtu = 23; reqInterval = 50; }
+  reqLink   = true;
+  linkUp    = connected;
+}
+
+void ble_live_set_mtu(uint16_t m){
+  reqMtu = m;
+  HLOGI("[BLE] MTU=%u -> %u frames/notify max\n", (unsigned)m, (unsigned)fit_frames(m));
+}
+
+void ble_live_set_interval(uint16_t ms){
+  reqInterval = ms ? ms : 50;
+}
+
+static void flush(){
+  if (!nBatched) return;
+  pkt[0] = LIVE_FRAME_VERSION;
+  pkt[1] = nBatched;
+  pLive->setValue(pkt, HDR_BYTES + nBatched * sizeof(HaloLiveFrame));
+  pLive->notify();
+  nBatched = 0;
+}
+
+void ble_live_tick(uint32_t now){
+  if (reqLink) { reqLink = false; nBatched = 0; mtuWarned = false; }
+  if (reqMtu != mtu) {
+    mtu = reqMtu;
+    if (nBatched >= fit_frames()) nBatched = 0;         // partial batch no longer fits: drop it
+  }
+  intervalMs = reqInterval;
+  if (!pLive || !linkUp || !rateHz) return;
+  if (!pCccd->getNotifications()) return;              // nobody subscribed: no work at all
+
+  if (fit_frames() == 0) {
+    if (!mtuWarned) { HLOGW("[BLE] LIVE needs MTU >= 43; stream paused\n"); mtuWarned = true; }
+    return;
+  }
+
+  const uint32_t period = 1000u / rateHz;
+  if ((int32_t)(now - nextSample) < 0) return;
+  nextSample = ((int32_t)(now - nextSample) > (int32_t)period) ? now + period : nextSample + period;
+
+  recompute_goal();
+  static HaloState st;
+  static uint32_t  seen = 0;
+  state_read(st, seen);
+  HaloLiveFrame f;
+  live_frame_fill(f, st, now);
+  memcpy(&pkt[HDR_BYTES + nBatched * sizeof(HaloLiveFrame)], &f, sizeof(f));
+  if (++nBatched >= batchGoal) flush();
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <Arduino.h>
+
+class BLEService;
+
+// Live telemetry stream: notify characteristic carrying packed HaloLiveFrame
+// batches. Write one byte to set the rate in Hz (0 = off, max LIVE_MAX_HZ).
+static constexpr uint8_t LIVE_DEFAULT_HZ = 2;
+static constexpr uint8_t LIVE_MAX_HZ     = 20;
+
+void ble_live_attach(BLEService* svc);                 // create characteristic (during BLE init)
+void ble_live_link(bool connected);                    // connect/disconnect edge
+void ble_live_set_mtu(uint16_t mtu);                   // negotiated ATT MTU
+void ble_live_set_interval(uint16_t conn_interval_ms); // negotiated connection interval
+void ble_live_tick(uint32_t now);                      // call from bleTick()
@@ -0,0 +1,103 @@
+#include "ble_nmea.h"
+#include "ble_ctrl.h"
+#include "../util/prof.h"
+#include "../util/hlog.h"
+
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+
+// ~0.5 s of FLARM output at 38400 baud. Lines are stored contiguously (a line
+// that does not fit before the end starts over at 0 and `wrapEnd` marks where
+// the old data stops), so a run of lines goes to setValue() in place.
+static const uint16_t RING_BYTES      = 2048;
+static const uint8_t  MAX_NOTIFY_TICK = 6;          // notifications per bleTick
+
+static BLECharacteristic* pTx   = nullptr;
+static BLE2902*           pCccd = nullptr;
+
+static volatile bool  active     = false;           // link up and subscribed (read by push)
+static volatile bool  sendFailed = false;           // set from notify() on GATT error
+static bool           linkUp     = false;
+static uint16_t       mtu        = 23;
+
+// Producer (push) and consumer (tick) both run on the control task
+static uint8_t  ring[RING_BYTES];
+static uint16_t head = 0, tail = 0, wrapEnd = RING_BYTES;
+static uint32_t dropped = 0;
+static uint32_t lastWarn = 0;
+
+class TxCallbacks : public BLECharacteristicCallbacks {
+  void onStatus(BLECharacteristic*, Status s, uint32_t) override {
+    if (s == Status::ERROR_GATT) sendFailed = true;
+  }
+};
+
+void ble_nmea_attach(BLEServer* server){
+  BLEService* svc = server->createService(BLEUUID(NMEA_SERVICE_UUID), 8);
+  pTx = svc->createCharacteristic(NMEA_TX_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+  pCccd = new BLE2902();
+  pTx->addDescriptor(pCccd);
+  static TxCallbacks cb;
+  pTx->setCallbacks(&cb);
+  svc->createCharacteristic(NMEA_RX_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR);
+  svc->start();
+}
+
+void ble_nmea_link(bool connected){
+  linkUp = connected;
+  if (!connected) { active = false; mtu = 23; }
+}
+
+void ble_nmea_set_mtu(uint16_t m){ mtu = m; }
+
+void ble_nmea_push(const char* s, size_t len){
+  if (!active) return;
+  PROF_SCOPE(PROF_NMEA_PUSH);
+  const uint16_t n = (uint16_t)(len + 2);
+  if (len == 0 || n > RING_BYTES / 4) return;
+  if (head == tail) head = tail = 0;                 // empty: restart at 0, never wrap
+  uint16_t at;
+  if (head >= tail) {
+    if (RING_BYTES - head >= n) at = head;
+    else if (tail > n)          { wrapEnd = head; at = 0; }
+    else                        { dropped++; return; }
+  } else if (tail - head > n)   at = head;
+  else                          { dropped++; return; }
+  memcpy(&ring[at], s, len);
+  ring[at + len] = '\r'; ring[at + len + 1] = '\n';
+  head = at + n;
+}
+
+// Bytes of the next notification starting at `tail`: the whole lines that fit
+// in `cap`, or `cap` bytes of a line longer than that.
+static uint16_t next_run(uint16_t cap){
+  if (head < tail && tail == wrapEnd) { tail = 0; wrapEnd = RING_BYTES; }
+  const uint16_t avail = (head >= tail) ? head - tail : wrapEnd - tail;
+  if (avail <= cap) return avail;                    // data only ever ends on a line boundary
+  for (uint16_t k = cap; k > 0; --k)
+    if (ring[tail + k - 1] == '\n') return k;
+  return cap;
+}
+
+void ble_nmea_tick(uint32_t now){
+  if (!pTx) return;
+  active = linkUp && pCccd->getNotifications();
+  if (!active) { head = tail = 0; wrapEnd = RING_BYTES; return; }
+
+  if (dropped && now - lastWarn >= 5000) {
+    HLOGW("[BLE] NMEA %lu line(s) dropped (client behind)\n", (unsigned long)dropped);
+    dropped = 0; lastWarn = now;
+  }
+
+  const uint16_t cap = (uint16_t)min<int>(mtu - 3, HALO_BLE_MTU - 3);   // ATT notify header is 3 bytes
+  for (uint8_t i = 0; i < MAX_NOTIFY_TICK && head != tail; ++i) {
+    const uint16_t k = next_run(cap);
+    if (!k) break;
+    sendFailed = false;
+    pTx->setValue(&ring[tail], k);
+    pTx->notify();
+    if (sendFailed) break;                           // stack full: keep the bytes, retry next tick
+    tail += k;
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+
+class BLEServer;
+
+// NMEA bridge for EFB apps (XCSoar etc.): a Nordic-UART-style service that
+// forwards the raw lines nav_tick() receives, CRLF-terminated.
+//
+// Lines are copied once into a byte ring, whole or not at all: a line that
+// does not fit is dropped and counted, so the client never sees a partial
+// sentence. bleTick() sends runs of whole lines from the ring as MTU-sized
+// notifications; a line longer than one notification is split but always
+// sent complete. Nothing is copied unless a client has subscribed.
+#define NMEA_SERVICE_UUID  "6e400001-b5a3-f393-e0a9-e50e24dcca9e"
+#define NMEA_RX_UUID       "6e400002-b5a3-f393-e0a9-e50e24dcca9e"   // write (accepted, ignored: no UART TX)
+#define NMEA_TX_UUID       "6e400003-b5a3-f393-e0a9-e50e24dcca9e"   // notify
+
+void ble_nmea_attach(BLEServer* server);        // create + start the service (during BLE init)
+void ble_nmea_link(bool connected);             // connect/disconnect edge
+void ble_nmea_set_mtu(uint16_t mtu);            // negotiated ATT MTU
+void ble_nmea_tick(uint32_t now);               // call from bleTick()
+
+// Control task, per parsed line (no CR/LF). O(len) copy, or one flag test
+// with no subscriber; timed as PROF_NMEA_PUSH.
+void ble_nmea_push(const char* s, size_t len);
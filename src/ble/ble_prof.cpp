@@ -0,0 +1,48 @@
+#include "ble_prof.h"
+#include "ble_ctrl.h"
+#include "../util/prof.h"
+#include "../util/hlog.h"
+
+#include <BLEDevice.h>
+#include <BLEServer.h>
+
+static BLECharacteristic* pProf = nullptr;
+static volatile bool      resetReq = false;
+static volatile uint8_t   firstSection = 0;
+
+// One page of records; stays under the 512-byte attribute limit
+static uint8_t profBuf[4 + BLE_PROF_PAGE * sizeof(ProfWire)];
+static_assert(sizeof(profBuf) <= 512, "profiler readout exceeds the ATT attribute limit");
+
+class ProfCallbacks : public BLECharacteristicCallbacks {
+  // Only the first chunk of a long read triggers onRead, so the snapshot stays
+  // consistent across the blob reads that follow.
+  void onRead(BLECharacteristic* c) override {
+    size_t n = prof_pack(profBuf, sizeof(profBuf), firstSection);
+    c->setValue(profBuf, n);
+  }
+  void onWrite(BLECharacteristic* c) override {
+    std::string v = c->getValue();
+    if (v.empty()) return;
+    const uint8_t k = (uint8_t)v[0];
+    if (k == BLE_PROF_RESET) resetReq = true;
+    else firstSection = (uint8_t)min<uint8_t>(k, PROF_COUNT);
+  }
+};
+
+void ble_prof_attach(BLEService* svc){
+  pProf = svc->createCharacteristic(PROFILE_CHARACTERISTIC_UUID,
+                                    BLECharacteristic::PROPERTY_READ |
+                                    BLECharacteristic::PROPERTY_WRITE);
+  static ProfCallbacks cb;
+  pProf->setCallbacks(&cb);
+  size_t n = prof_pack(profBuf, sizeof(profBuf));
+  pProf->setValue(profBuf, n);
+}
+
+void ble_prof_tick(uint32_t){
+  if (!pProf || !resetReq) return;
+  resetReq = false;
+  prof_reset();
+  HLOGI("[BLE] PROFILE reset\n");
+}
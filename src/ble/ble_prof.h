@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+class BLEService;
+
+// Profiler readout (see util/prof.h): read/write characteristic.
+// Read:  [version][total][first][n][n x ProfWire]   (refreshed on each read; long read)
+//        up to BLE_PROF_PAGE sections starting at `first`
+// Write: [k] selects the first section of the next read; [0xFF] resets the counters.
+static constexpr uint8_t BLE_PROF_PAGE  = 10;
+static constexpr uint8_t BLE_PROF_RESET = 0xFF;
+
+void ble_prof_attach(BLEService* svc);   // create characteristic (during BLE init)
+void ble_prof_tick(uint32_t now);        // call from bleTick(); applies a queued reset
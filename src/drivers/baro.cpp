@@ -0,0 +1,110 @@
+#include "baro.h"
+#include "../util/hlog.h"
+#include <Adafruit_BMP280.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static Adafruit_BMP280 bmp;
+
+struct ProfileCfg {
+  Adafruit_BMP280::sensor_mode      mode;
+  Adafruit_BMP280::sensor_sampling  osrs_t, osrs_p;
+  Adafruit_BMP280::sensor_filter    filter;
+  Adafruit_BMP280::standby_duration standby;
+  uint16_t period_ms;      // conversion start to start (forced: our trigger interval)
+  uint8_t  meas_ms;        // typical conversion time (datasheet: 1 + 2*T + 2*P + 0.5 ms)
+};
+
+static const ProfileCfg PROFILES[BARO_PROFILES] = {
+  { Adafruit_BMP280::MODE_FORCED, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X4,
+    Adafruit_BMP280::FILTER_X4,   Adafruit_BMP280::STANDBY_MS_1,   1000, 12 },
+  { Adafruit_BMP280::MODE_NORMAL, Adafruit_BMP280::SAMPLING_X2, Adafruit_BMP280::SAMPLING_X16,
+    Adafruit_BMP280::FILTER_X4,   Adafruit_BMP280::STANDBY_MS_250,  288, 38 },
+  { Adafruit_BMP280::MODE_NORMAL, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X8,
+    Adafruit_BMP280::FILTER_X2,   Adafruit_BMP280::STANDBY_MS_63,    82, 20 },
+};
+static const char* const NAMES[BARO_PROFILES] = { "ground", "cruise", "fast" };
+
+static const uint8_t STATUS_MEASURING = 0x08;
+
+static bool              present   = false;
+static volatile uint8_t  want      = BARO_GROUND;
+static volatile uint8_t  cur       = BARO_GROUND;
+static uint32_t          lastReady = 0;          // 0 = not synchronised to the sensor
+static uint32_t          period_q4 = 0;          // normal-mode period, ms * 16
+static bool              measured  = false;      // period_q4 comes from the sensor, not the datasheet
+
+static void configure(uint8_t p){
+  const ProfileCfg& c = PROFILES[p];
+  // Config (standby, filter) writes are only reliable in sleep mode
+  bmp.setSampling(Adafruit_BMP280::MODE_SLEEP, c.osrs_t, c.osrs_p, c.filter, c.standby);
+  if (c.mode == Adafruit_BMP280::MODE_NORMAL) bmp.setSampling(c.mode, c.osrs_t, c.osrs_p, c.filter, c.standby);
+  cur = p;
+  lastReady = 0;
+  period_q4 = (uint32_t)c.period_ms << 4;
+  measured  = false;
+}
+
+bool baro_begin(uint8_t addr){
+  if (!bmp.begin(addr)) return false;
+  configure(BARO_GROUND);
+  present = true;
+  return true;
+}
+
+void baro_request(BaroProfile p){ if (p < BARO_PROFILES) want = p; }
+BaroProfile baro_profile(){ return (BaroProfile)cur; }
+const char* baro_profile_name(BaroProfile p){ return p < BARO_PROFILES ? NAMES[p] : "?"; }
+
+static void sleep_until(uint32_t t){
+  const int32_t d = (int32_t)(t - millis());
+  if (d > 0) vTaskDelay(pdMS_TO_TICKS(d));
+}
+
+// Poll until a conversion ends. needStart: first see the bit set, so a
+// conversion that has not begun yet isn't mistaken for a finished one.
+static uint32_t wait_edge(bool needStart, uint32_t limit_ms){
+  const uint32_t t0 = millis();
+  bool seen = !needStart;
+  while (millis() - t0 < limit_ms) {
+    if (bmp.getStatus() & STATUS_MEASURING) seen = true;
+    else if (seen) return millis();
+    vTaskDelay(1);
+  }
+  return 0;
+}
+
+uint32_t baro_wait(){
+  if (!present) { vTaskDelay(pdMS_TO_TICKS(1000)); return 0; }
+  if (want != cur) {
+    configure(want);
+    HLOGI("[BARO] profile %s\n", NAMES[cur]);
+  }
+  const ProfileCfg& c = PROFILES[cur];
+  uint32_t ready;
+  if (c.mode == Adafruit_BMP280::MODE_FORCED) {
+    if (lastReady) sleep_until(lastReady + c.period_ms - c.meas_ms);
+    bmp.setSampling(c.mode, c.osrs_t, c.osrs_p, c.filter, c.standby);   // starts one conversion
+    vTaskDelay(pdMS_TO_TICKS(c.meas_ms - 2));
+    ready = wait_edge(false, c.meas_ms);
+  } else {
+    // Wake shortly before the predicted end. The sensor's own clock is several
+    // % off nominal, so the prediction uses the period measured between edges
+    // (with a wide margin until there is one).
+    const uint32_t period = period_q4 >> 4;
+    if (lastReady) sleep_until(lastReady + period - 3 - (measured ? 0 : period / 8));
+    ready = wait_edge(true, c.period_ms + c.meas_ms);
+    const uint32_t d = ready - lastReady;
+    if (lastReady && ready && d * 5 > c.period_ms * 4u && d * 4 < c.period_ms * 5u) {
+      period_q4 = measured ? period_q4 + ((int32_t)(d << 4) - (int32_t)period_q4) / 8 : d << 4;
+      measured  = true;
+    }
+  }
+  lastReady = ready;
+  return ready;
+}
+
+void baro_sample(float& tC, float& pPa){
+  tC  = bmp.readTemperature();
+  pPa = bmp.readPressure();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+// BMP280 sampling profiles, picked by the control task from the flight phase.
+//   BARO_GROUND : forced mode, one conversion a second, P x4 / T x1, IIR 4
+//   BARO_CRUISE : normal mode, ~3.5 Hz, P x16 / T x2, IIR 4
+//   BARO_FAST   : normal mode, ~12 Hz, P x8 / T x1, IIR 2 (takeoff, approach, landing)
+// Higher values sample faster. The sensor task waits for each conversion to
+// finish (status "measuring" bit) and stamps the sample with that time rather
+// than with a fixed poll, so consecutive samples are spaced as the sensor
+// produced them and the newest one is at most a couple of ms old.
+enum BaroProfile : uint8_t { BARO_GROUND, BARO_CRUISE, BARO_FAST, BARO_PROFILES };
+
+bool baro_begin(uint8_t addr);            // setup(): probe + BARO_GROUND; false = no sensor
+void baro_request(BaroProfile p);         // any task; applied before the next sample
+BaroProfile baro_profile();               // profile in effect
+const char* baro_profile_name(BaroProfile p);
+
+// Sensor task only: apply a pending profile, then block until the next
+// conversion completes. Returns its millis() (0 = timed out, sample unaligned).
+uint32_t baro_wait();
+// Sensor task only: read the finished conversion (NaN on bus error)
+void baro_sample(float& tC, float& pPa);
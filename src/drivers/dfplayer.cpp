@@ -1,4 +1,7 @@
 #include "dfplayer.h"
+#include "../app/rtos_cfg.h"
+#include "../util/prof.h"
+#include <freertos/queue.h>
 
 // Minimal non-blocking DFPlayer protocol (clone-friendly)
 static HardwareSerial* dfp = nullptr;
@@ -10,6 +13,7 @@ static bool busyNow=false, busyPrev=false;
 static uint32_t busyEdgeT=0;
 
 static uint16_t df_index = 1; // last index sent
+static uint32_t df_trace = 0; // latency tag of df_index
 static uint32_t df_t=0;
 
 enum : uint8_t {
@@ -20,13 +24,14 @@ static uint8_t  m_state = M_OFF;
 
 static const int QSIZE=8;
 static uint16_t qbuf[QSIZE];
+static uint32_t qtag[QSIZE];
 static uint8_t qh=0, qt=0;
 static bool qfull=false;
 
 static inline bool qEmpty(){ return (qh==qt) && !qfull; }
 static inline void qClear(){ qh=qt=0; qfull=false; }
-static inline bool qEnq(uint16_t n){ if(qfull) return false; qbuf[qh]=n; qh=(qh+1)%QSIZE; if(qh==qt) qfull=true; return true; }
-static inline bool qDeq(uint16_t &n){ if(qEmpty()) return false; n=qbuf[qt]; qt=(qt+1)%QSIZE; qfull=false; return true; }
+static inline bool qEnq(uint16_t n, uint32_t tag){ if(qfull) return false; qbuf[qh]=n; qtag[qh]=tag; qh=(qh+1)%QSIZE; if(qh==qt) qfull=true; return true; }
+static inline bool qDeq(uint16_t &n, uint32_t &tag){ if(qEmpty()) return false; n=qbuf[qt]; tag=qtag[qt]; qt=(qt+1)%QSIZE; qfull=false; return true; }
 
 static void df_send(uint8_t cmd, uint16_t param){
   if(!dfp) return;
@@ -35,23 +40,51 @@ static void df_send(uint8_t cmd, uint16_t param){
   dfp->write(b,10);
 }
 
-static inline void df_play_current(){ df_send(0x12, df_index); df_playCmdAt=millis(); }
+static inline void df_play_current(){ df_send(0x12, df_index); df_playCmdAt=millis(); prof_trace(PROF_LAT_AUDIO, df_trace); }
 
-void dfp_play_filename(uint16_t n){
+// Requests from any task go through a FreeRTOS queue; only dfp_tick() touches
+// the UART and the play queue.
+enum : uint8_t { DC_PLAY, DC_STOP_FLUSH, DC_CLEAR, DC_STOP, DC_VOLUME };
+struct DfCmd { uint8_t op; uint16_t arg; uint32_t tag; };
+static QueueHandle_t cmdQ = nullptr;
+
+static void post(uint8_t op, uint16_t arg, uint32_t tag = 0){
+  if(!cmdQ) return;
+  DfCmd c = { op, arg, tag };
+  xQueueSend(cmdQ, &c, 0);       // full queue: drop rather than block the caller
+}
+
+void dfp_play_filename(uint16_t n, uint32_t trace){
   if(n<1) n=1; if(n>3000) n=3000;
-  qEnq(n);
+  post(DC_PLAY, n, trace);
 }
 
 void dfp_begin(HardwareSerial& serial, int txPin, int busyPin, uint32_t baud, uint8_t volume0_30){
   dfp=&serial; df_tx=txPin; df_busy=busyPin; df_vol = volume0_30;
+  if(!cmdQ) cmdQ = xQueueCreate(AUDIO_QUEUE, sizeof(DfCmd));
   dfp->begin(baud, SERIAL_8N1, -1, df_tx);
   pinMode(df_busy, INPUT_PULLUP);
   busyPrev=busyNow=(digitalRead(df_busy)==LOW);
   m_state = M_SETTLE; df_t=millis();
 }
 
+static void do_stop_and_flush();
+static void do_stop();
+
 void dfp_tick(){
   if(!dfp || m_state==M_OFF) return;
+
+  DfCmd c;
+  while(xQueueReceive(cmdQ, &c, 0) == pdTRUE){
+    switch(c.op){
+      case DC_PLAY:       qEnq(c.arg, c.tag); break;
+      case DC_STOP_FLUSH: do_stop_and_flush(); break;
+      case DC_CLEAR:      qClear(); break;
+      case DC_STOP:       do_stop(); break;
+      case DC_VOLUME:     df_vol = (uint8_t)min<uint16_t>(c.arg, 30); df_send(0x06, df_vol); break;
+    }
+  }
+
   uint32_t now=millis();
   // debounced busy
   bool raw=(digitalRead(df_busy)==LOW);
@@ -88,7 +121,7 @@ void dfp_tick(){
 
     case M_MONITOR:
       if(!busyNow && !qEmpty() && (now-df_t>=60)){
-        uint16_t n; qDeq(n); df_index=n;
+        uint16_t n; qDeq(n, df_trace); df_index=n;
         df_send(0x16,0);          // polite STOP before new play
         df_t=now; m_state=M_PLAY_STOP;
       }
@@ -116,7 +149,7 @@ void dfp_tick(){
 
 // ---- Public control helpers ----
 
-void dfp_stop_and_flush(){
+static void do_stop_and_flush(){
   // hard reset: stop playback and clear queued items
   qClear();
   df_send(0x16,0);          // STOP
@@ -124,14 +157,18 @@ void dfp_stop_and_flush(){
   m_state = M_MONITOR;
 }
 
-void dfp_clear_queue(){
-  // compatibility: only clear pending queue
-  qClear();
-}
-
-void dfp_stop(){
-  // compatibility: only send STOP (do not clear queue)
+static void do_stop(){
   df_send(0x16,0);
   df_t = millis();
   m_state = M_MONITOR;
 }
+
+void dfp_stop_and_flush(){ post(DC_STOP_FLUSH, 0); }
+
+// compatibility: only clear pending queue
+void dfp_clear_queue(){ post(DC_CLEAR, 0); }
+
+// compatibility: only send STOP (do not clear queue)
+void dfp_stop(){ post(DC_STOP, 0); }
+
+void dfp_set_volume(uint8_t vol0_30){ post(DC_VOLUME, vol0_30); }
@@ -4,11 +4,13 @@
 // Initialize DFPlayer (TX pin to module RX, module BUSY pin is active-LOW)
 void dfp_begin(HardwareSerial& serial, int txPin, int busyPin, uint32_t baud, uint8_t volume0_30);
 
-// Non-blocking tick (call every loop)
+// Non-blocking tick; call periodically from the audio task. All other calls
+// below only post a request, so they are safe from any task.
 void dfp_tick();
 
-// Enqueue a filename index (1..3000) to play (maps to /MP3/00NN.mp3)
-void dfp_play_filename(uint16_t n);
+// Enqueue a filename index (1..3000) to play (maps to /MP3/00NN.mp3).
+// trace: alert latency tag (see util/prof.h), recorded when the play command is sent.
+void dfp_play_filename(uint16_t n, uint32_t trace = 0);
 
 // Stop current playback and drop any queued items (compat: use if you want a hard reset)
 void dfp_stop_and_flush();
@@ -19,3 +21,6 @@ void dfp_clear_queue();
 
 // Send STOP to the module (does not clear queued items).
 void dfp_stop();
+
+// Set output volume (0..30) right away, between tracks or not.
+void dfp_set_volume(uint8_t vol0_30);
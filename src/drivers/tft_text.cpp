@@ -0,0 +1,153 @@
+#include "tft_text.h"
+
+// 5x7 source glyphs, column-major, bit 0 = top row (classic GFX layout)
+static const char    CHARSET[] = " -.:0123456789CPafhkst";
+static const uint8_t FONT5x7[][5] = {
+  {0x00,0x00,0x00,0x00,0x00}, // ' '
+  {0x08,0x08,0x08,0x08,0x08}, // '-'
+  {0x00,0x60,0x60,0x00,0x00}, // '.'
+  {0x00,0x36,0x36,0x00,0x00}, // ':'
+  {0x3E,0x51,0x49,0x45,0x3E}, // '0'
+  {0x00,0x42,0x7F,0x40,0x00}, // '1'
+  {0x72,0x49,0x49,0x49,0x46}, // '2'
+  {0x21,0x41,0x49,0x4D,0x33}, // '3'
+  {0x18,0x14,0x12,0x7F,0x10}, // '4'
+  {0x27,0x45,0x45,0x45,0x39}, // '5'
+  {0x3C,0x4A,0x49,0x49,0x31}, // '6'
+  {0x41,0x21,0x11,0x09,0x07}, // '7'
+  {0x36,0x49,0x49,0x49,0x36}, // '8'
+  {0x46,0x49,0x49,0x29,0x1E}, // '9'
+  {0x3E,0x41,0x41,0x41,0x22}, // 'C'
+  {0x7F,0x09,0x09,0x09,0x06}, // 'P'
+  {0x20,0x54,0x54,0x78,0x40}, // 'a'
+  {0x08,0x7E,0x09,0x01,0x02}, // 'f'
+  {0x7F,0x08,0x04,0x04,0x78}, // 'h'
+  {0x00,0x7F,0x10,0x28,0x44}, // 'k'
+  {0x48,0x54,0x54,0x54,0x24}, // 's'
+  {0x04,0x3F,0x44,0x40,0x20}, // 't'
+};
+static const uint8_t NGLYPH = sizeof(FONT5x7) / sizeof(FONT5x7[0]);
+static_assert(sizeof(CHARSET) - 1 == sizeof(FONT5x7) / sizeof(FONT5x7[0]), "charset/font mismatch");
+
+static const uint8_t SS      = 4;          // supersampling per axis
+static const int16_t LINE_MAX = 160;       // widest string row (panel width)
+
+// Per size: 6s x 8s cells, 2 bits per pixel, row-major
+static const uint16_t CELL2 = (12 * 16) / 4, CELL3 = (18 * 24) / 4;
+static uint8_t  cache2[NGLYPH][CELL2];
+static uint8_t  cache3[NGLYPH][CELL3];
+static uint8_t  glyphOf[128];              // ASCII -> glyph index (0 = blank)
+static Adafruit_ST7735* dev = nullptr;
+
+static inline bool src_px(const uint8_t* g, int c, int r){
+  return c >= 0 && c < 5 && r >= 0 && r < 7 && ((g[c] >> r) & 1);
+}
+
+// Squared distance from (u, v) to the segment (ax, ay)-(ax+dx, ay+1), dx = +-1
+static inline float seg_d2(float u, float v, float ax, float ay, float dx){
+  float t = ((u - ax) * dx + (v - ay)) * 0.5f;
+  t = t < 0 ? 0 : (t > 1 ? 1 : t);
+  const float px = u - (ax + dx * t), py = v - (ay + t);
+  return px * px + py * py;
+}
+
+// Coverage of one source glyph at scale s: each set pixel is an s x s block,
+// and two diagonal neighbours with both shared neighbours clear are joined by
+// a one-pixel-wide stroke, which fills the stair-step notches.
+static void rasterize(const uint8_t* g, uint8_t s, uint8_t* out){
+  const int W = 6 * s, H = 8 * s;
+  memset(out, 0, (W * H) / 4);
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      int hits = 0;
+      for (int sy = 0; sy < SS; ++sy) {
+        for (int sx = 0; sx < SS; ++sx) {
+          const float u = (x + (sx + 0.5f) / SS) / s, v = (y + (sy + 0.5f) / SS) / s;  // source units
+          const int c = (int)u, r = (int)v;
+          bool on = src_px(g, c, r);
+          // diagonals of the 2x2 neighbourhoods around this source cell
+          for (int dc = -1; !on && dc <= 0; ++dc) {
+            for (int dr = -1; !on && dr <= 0; ++dr) {
+              const int c0 = c + dc, r0 = r + dr;
+              const bool a = src_px(g, c0, r0),     b = src_px(g, c0 + 1, r0);
+              const bool l = src_px(g, c0, r0 + 1), d = src_px(g, c0 + 1, r0 + 1);
+              if (a && d && !b && !l && seg_d2(u, v, c0 + 0.5f, r0 + 0.5f,  1.0f) <= 0.25f) on = true;
+              if (b && l && !a && !d && seg_d2(u, v, c0 + 1.5f, r0 + 0.5f, -1.0f) <= 0.25f) on = true;
+            }
+          }
+          hits += on;
+        }
+      }
+      const uint8_t level = (uint8_t)((hits * 3 + (SS * SS) / 2) / (SS * SS));   // 0..3
+      const int i = y * W + x;
+      out[i >> 2] |= level << ((i & 3) * 2);
+    }
+  }
+}
+
+void tft_text_begin(Adafruit_ST7735& tft){
+  dev = &tft;
+  memset(glyphOf, 0, sizeof(glyphOf));
+  for (uint8_t i = 0; i < NGLYPH; ++i) {
+    glyphOf[(uint8_t)CHARSET[i]] = i;
+    rasterize(FONT5x7[i], 2, cache2[i]);
+    rasterize(FONT5x7[i], 3, cache3[i]);
+  }
+}
+
+// RGB565 blend, k/3 of fg over bg
+static uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t k){
+  const int r = ((fg >> 11) * k + (bg >> 11) * (3 - k) + 1) / 3;
+  const int g = (((fg >> 5) & 63) * k + ((bg >> 5) & 63) * (3 - k) + 1) / 3;
+  const int b = ((fg & 31) * k + (bg & 31) * (3 - k) + 1) / 3;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static int16_t draw_cells(int16_t x, int16_t y, const char* s, uint8_t n, uint8_t padL, uint8_t padR,
+                          uint8_t size, uint16_t fg, uint16_t bg){
+  if (!dev || (size != 2 && size != 3)) return 0;
+  const int16_t cw = 6 * size, ch = 8 * size;
+  uint8_t cells = padL + n + padR;
+  while (cells && x + cells * cw > dev->width()) { if (padR) padR--; else if (n) n--; else padL--; cells--; }
+  const int16_t w = cells * cw;
+  if (!w || x < 0 || y < 0 || y + ch > dev->height()) return 0;
+
+  const uint16_t pal[4] = { bg, blend565(fg, bg, 1), blend565(fg, bg, 2), fg };
+  static uint16_t line[LINE_MAX];
+  const uint8_t* glyphs[LINE_MAX / 12];
+  for (uint8_t i = 0; i < cells; ++i) {
+    const bool pad = i < padL || i >= padL + n;
+    const uint8_t ch7 = pad ? 0 : ((uint8_t)s[i - padL] & 0x7F);
+    const uint8_t g = glyphOf[ch7];
+    glyphs[i] = (size == 2) ? cache2[g] : cache3[g];
+  }
+
+  dev->startWrite();
+  dev->setAddrWindow(x, y, w, ch);
+  for (int16_t r = 0; r < ch; ++r) {
+    uint16_t* p = line;
+    for (uint8_t i = 0; i < cells; ++i) {
+      const uint8_t* cov = glyphs[i];
+      int idx = r * cw;
+      for (int16_t c = 0; c < cw; ++c, ++idx) *p++ = pal[(cov[idx >> 2] >> ((idx & 3) * 2)) & 3];
+    }
+    dev->writePixels(line, w);
+  }
+  dev->endWrite();
+  return w;
+}
+
+int16_t tft_text_draw(int16_t x, int16_t y, const char* s, uint8_t size,
+                      uint16_t fg, uint16_t bg, uint8_t field){
+  const uint8_t n = (uint8_t)strlen(s);
+  return draw_cells(x, y, s, n, 0, field > n ? field - n : 0, size, fg, bg);
+}
+
+int16_t tft_text_draw_right(int16_t xRight, int16_t y, const char* s, uint8_t size,
+                            uint16_t fg, uint16_t bg, uint8_t field){
+  const uint8_t n = (uint8_t)strlen(s);
+  const uint8_t padL = field > n ? field - n : 0;
+  int16_t x = xRight - tft_text_width(padL + n, size);
+  if (x < 0) x = 0;
+  return draw_cells(x, y, s, n, padL, 0, size, fg, bg);
+}
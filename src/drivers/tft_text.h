@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+
+// Fast text for the live values on the ST7735.
+//
+// GFX print() at text size 2/3 draws every font pixel as its own fillRect. Here
+// the glyphs used by the value fields (digits, sign, ':' '.', units) are
+// pre-rasterized once per size into a 2-bit coverage cache: the 5x7 font is
+// supersampled 4x4 with diagonal strokes joined, so edges come out
+// anti-aliased. A string is then one setAddrWindow() over its whole box and
+// one writePixels() per row inside a single SPI transaction. Characters
+// outside the cached set draw as blanks.
+void tft_text_begin(Adafruit_ST7735& tft);     // build the caches (~tens of ms, CPU only)
+
+// Width in pixels of `n` cells at `size` (6 * size per cell)
+inline int16_t tft_text_width(uint8_t n, uint8_t size){ return (int16_t)(n * 6 * size); }
+
+// Draw `s` at size 2 or 3 with its top-left at (x, y). field > strlen(s) pads
+// with background cells, so a shorter value erases the longer one before it.
+// Returns the width drawn.
+int16_t tft_text_draw(int16_t x, int16_t y, const char* s, uint8_t size,
+                      uint16_t fg, uint16_t bg, uint8_t field = 0);
+// Same, right-aligned to xRight (padding goes on the left)
+int16_t tft_text_draw_right(int16_t xRight, int16_t y, const char* s, uint8_t size,
+                            uint16_t fg, uint16_t bg, uint8_t field = 0);
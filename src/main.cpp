@@ -3,10 +3,10 @@
 #include <SPI.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7735.h>
-#include <Adafruit_BMP280.h>
 #include <pgmspace.h>
 #include <ctype.h>
 #include <math.h>
+#include <esp_system.h>
 
 #include "version.h"
 #include "splash_image.h"
@@ -15,12 +15,36 @@
 #include "app/telemetry.h"
 #include "app/ui_iface.h"
 #include "app/app_fsm.h"
+#include "app/rtos_cfg.h"
+#include "app/state_store.h"
+#include "app/prompts.h"
 
 #include "drivers/dfplayer.h"
+#include "drivers/tft_text.h"
+#include "drivers/baro.h"
 #include "nav/flarm.h"
+#include "nav/traffic.h"
+#include "nav/heading.h"
+#include "nav/geom.h"
+#include "nav/geom_bench.h"
+#include "nav/airfields.h"
 #include "storage/nvs_store.h"
+#include "storage/logbook.h"
+#include "storage/encounters.h"
+#include "storage/assets.h"
+#include "storage/fdr.h"
 
 #include "ble/ble_ctrl.h"   // BLE control plane + app hooks declarations
+#include "util/prof.h"
+#include "util/hlog.h"
+#include "util/fixed_trig.h"
+#include "util/fmt_int.h"
+#include "util/spsc_queue.h"
+#include "app/power.h"
+#include "app/data_port.h"
+
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
 // ---------------- Pins ----------------
 #define I2C_SDA   4
@@ -38,31 +62,14 @@
 #define DF_BUSY_PIN     7    // active LOW while playing
 // FLARM / SoftRF RX-only UART
 #define FLARM_RX_PIN    8
+#define FLARM_UART      2
 // Strobe MOSFET gate
 #define STROBE_PIN      6
 
 // ---------------- Devices ----------------
 Adafruit_ST7735 tft(TFT_CS, TFT_DC, TFT_RST);
-Adafruit_BMP280  bmp;
 HardwareSerial   DFSerial(1);
-HardwareSerial   FLARM(2);
-
-// --- DFPlayer raw command helpers (no re-init needed) ---
-static void df_send_cmd(uint8_t cmd, uint16_t param) {
-  uint8_t buf[10];
-  buf[0]=0x7E; buf[1]=0xFF; buf[2]=0x06; buf[3]=cmd; buf[4]=0x00;
-  buf[5]=(uint8_t)(param >> 8); buf[6]=(uint8_t)(param & 0xFF);
-  uint16_t sum = 0;
-  for (int i=1; i<=6; ++i) sum += buf[i];
-  uint16_t chk = 0xFFFF - sum + 1;
-  buf[7]=(uint8_t)(chk >> 8); buf[8]=(uint8_t)(chk & 0xFF); buf[9]=0xEF;
-  DFSerial.write(buf, sizeof(buf));
-  DFSerial.flush();
-}
-static inline void df_set_volume_immediate(uint8_t vol0_30) {
-  if (vol0_30 > 30) vol0_30 = 30;
-  df_send_cmd(0x06, vol0_30);
-}
+HardwareSerial   FLARM(FLARM_UART);
 
 // --- Auto-baud recovery after a data-source/baud change ---
 static bool     nav_autobaud_arm = false;
@@ -107,7 +114,7 @@ float baselineAlt_m = NAN;
 // Extern for baro math
 float seaLevel_hPa = 1013.25f;
 
-// Plays track 2 once when nav becomes valid
+// Plays the nav-valid chime once when nav becomes valid
 static bool navWasValid = false;
 
 // ---------------- Strobe ----------------
@@ -136,29 +143,47 @@ static NavEdgeState navEdge = NAV_INV;
 static uint32_t     navEdge_t = 0;
 
 // ---------------- UI page state ----------------
+// The control task owns the page; the UI task renders from its copy of the
+// state store, so drawing never reads state another task is writing.
+static HaloState ui;                     // UI task's copy
+static uint32_t  uiNow = 0;              // UI task's frame time
+
 static bool pageDrawn[5] = {false,false,false,false,false};
 static inline void markAllUndrawn_local(){ for(int i=0;i<5;i++) pageDrawn[i]=false; }
 Page g_current_page = PAGE_BOOT;
+static uint32_t uiRedraw = 0;
 
 void ui_set_page(Page p){
   g_current_page = p;
-  markAllUndrawn_local();
-  const char* pname =
-    (p==PAGE_BOOT)?"BOOT":(p==PAGE_COMPASS)?"CRUISE":(p==PAGE_TRAFFIC)?"TRAFFIC":(p==PAGE_LANDING)?"LANDING":"LANDED";
-  Serial.printf("[UI ] page -> %s\n", pname);
+  uiRedraw++;
+  HLOGI("[UI ] page -> %s\n",
+    (p==PAGE_BOOT)?"BOOT":(p==PAGE_COMPASS)?"CRUISE":(p==PAGE_TRAFFIC)?"TRAFFIC":(p==PAGE_LANDING)?"LANDING":"LANDED");
 }
-void ui_markAllUndrawn(){ markAllUndrawn_local(); }
+void ui_markAllUndrawn(){ uiRedraw++; }
 
 // ---------------- Timing ----------------
 uint32_t bootShownSince_ms = 0;
-uint32_t lastSensor=0, lastUI=0;
 
 // ---------------- Splash ----------------
 enum SplashState { SPLASH_START, SPLASH_SHOW_IMG, SPLASH_HOLD_IMG, SPLASH_SHOW_VER, SPLASH_HOLD_VER, SPLASH_DONE };
-SplashState splash = SPLASH_START; uint32_t splash_t = 0;
+volatile SplashState splash = SPLASH_START; uint32_t splash_t = 0;
 
-// WDT-friendly blit (yield periodically)
+// WDT-friendly blit (yield periodically). The "splash" asset is streamed
+// straight from mapped flash; the compiled-in image is the fallback.
 static void drawSplashImageProgmem(){
+  uint16_t w = 0, h = 0;
+  const uint16_t* px = assets_image("splash", w, h);
+  if (px && w <= tft.width() && h <= tft.height()) {
+    const int16_t x0 = (tft.width() - w) / 2, y0 = (tft.height() - h) / 2;
+    tft.startWrite();
+    tft.setAddrWindow(x0, y0, w, h);
+    for(uint16_t y=0; y<h; ++y){
+      if ((y & 7) == 0) yield();
+      tft.writePixels(const_cast<uint16_t*>(px + (uint32_t)y * w), w);   // read-only; no copy
+    }
+    tft.endWrite();
+    return;
+  }
   tft.startWrite();
   tft.setAddrWindow(0,0,160,128);
   for(int16_t y=0; y<128; ++y){
@@ -234,7 +259,7 @@ static void drawBadgeHeader(int x,int y,int w,int h, const char* txt, bool ok){
 static void drawHeaderBadges(bool flarm_ok){
   int w=tft.width(), h=12, by=1, wF=48, wS=56, gap=4;
   int bxF = w - wF - 2, bxS = bxF - gap - wS;
-  drawBadgeHeader(bxS, by, wS, h, "STROBE", strobe_enabled);
+  drawBadgeHeader(bxS, by, wS, h, "STROBE", ui.strobe_on);
   drawBadgeHeader(bxF, by, wF, h, "FLARM", flarm_ok);
 }
 
@@ -244,7 +269,7 @@ static bool boot_last_nav_ok2 = false;
 static void drawBootStatic(){
   tft.fillScreen(COL_BG);
   drawHeaderStrip(F("Pre-Flight Values"));
-  boot_last_nav_ok = navValid();
+  boot_last_nav_ok = ui.nav_ok;
   drawFlarmBadge(boot_last_nav_ok);
 
   const int xLabel = 6;
@@ -252,13 +277,19 @@ static void drawBootStatic(){
   const int y0 = 26;
   const int dy = 26;
 
+  // Labels in the asset "label" font when one is flashed, else the built-in
+  // 5x7 sized up. GFX fonts are positioned by their baseline.
+  const GFXfont* labelFont = assets_font("label");
+  const int yBase = labelFont ? 14 : 0;
   tft.setTextColor(COL(170,200,255));
-  tft.setTextSize(2);                  // labels size up
-  int y = y0;
+  if (labelFont) { tft.setFont(labelFont); tft.setTextSize(1); }
+  else           tft.setTextSize(2);
+  int y = y0 + yBase;
   tft.setCursor(xLabel,y); tft.print(F("Temp"));    y += dy;
   tft.setCursor(xLabel,y); tft.print(F("QNH"));     y += dy;
   tft.setCursor(xLabel,y); tft.print(F("FElev"));  y += dy;
   tft.setCursor(xLabel,y); tft.print(F("Vol"));
+  tft.setFont(nullptr);
 
   tft.fillRect(xValueLeft, y0-4, tft.width()-xValueLeft-6, dy*4+10, COL_BG);
 }
@@ -267,47 +298,41 @@ static void updBoot(){
   const int y0 = 26;
   const int dy = 26;
   const int marginR = 6;
-  const int charW = 12;               // 6px base * size 2
-  bool ok = navValid();
+  const uint8_t field = 7;            // "1013hPa"; stays clear of the labels
+  bool ok = ui.nav_ok;
   if (ok != boot_last_nav_ok){
     drawFlarmBadge(ok);
     boot_last_nav_ok = ok;
   }
   auto printRight = [&](const char* s, int y){
-    int x = tft.width() - marginR - (int)strlen(s) * charW;
-    if (x < 0) x = 0;
-    tft.setCursor(x, y);
-    tft.print(s);
+    tft_text_draw_right(tft.width() - marginR, y, s, 2, COL_FG, COL_BG, field);
   };
 
-  tft.setTextColor(COL_FG, COL_BG);
-  tft.setTextSize(2);
-
   char buf[24];
   int y = y0;
 
   // Temperature
-  if (tele.bmp_ok && !isnan(tele.tC)) {
-    snprintf(buf, sizeof(buf), "%dC", (int)lroundf(tele.tC));
+  if (ui.tele.bmp_ok && !isnan(ui.tele.tC)) {
+    fmt_str(buf + fmt_i32(buf, lroundf(ui.tele.tC)), "C");
   } else {
-    snprintf(buf, sizeof(buf), "--C");
+    fmt_str(buf, "--C");
   }
   printRight(buf, y); y += dy;
 
   // QNH
-  snprintf(buf, sizeof(buf), "%dhPa", (int)lroundf(qnh_hPa));
+  fmt_str(buf + fmt_i32(buf, lroundf(ui.qnh_hPa)), "hPa");
   printRight(buf, y); y += dy;
 
   // Airfield elevation
-  snprintf(buf, sizeof(buf), "%dft", (int)lroundf(airfieldElev_ft));
+  fmt_str(buf + fmt_i32(buf, lroundf(ui.elev_ft)), "ft");
   printRight(buf, y); y += dy;
 
   // Volume display 0..10
   {
-    int vol10 = (int)lroundf(df_volume / 3.0f);
+    int vol10 = (int)lroundf(ui.volume / 3.0f);
     if (vol10 < 0) vol10 = 0;
     if (vol10 > 10) vol10 = 10;
-    snprintf(buf, sizeof(buf), "%d", vol10);
+    fmt_i32(buf, vol10);
   }
   printRight(buf, y);
 }
@@ -320,21 +345,22 @@ static const char* label45(int d){
 }
 
 // ---------------- Cruise ----------------
-static void drawCompassTape(float heading_deg){
+static void drawCompassTape(int heading_deg){
   const int yTop=34, h=26;
-  const float pxPerDeg=1.25f;
+  // 1.25 px per degree, kept integer: dx = round(ddeg * 5 / 4)
   int w=tft.width(), cx=w/2;
 
   tft.fillRect(0,yTop,w,h,COL_BG);
   tft.drawFastHLine(0,yTop,w,COL_ACCENT);
   tft.drawFastHLine(0,yTop+h-1,w,COL_ACCENT);
 
-  int minDeg=(int)floor(heading_deg - (w/2)/pxPerDeg);
-  int maxDeg=(int)ceil(heading_deg + (w/2)/pxPerDeg);
+  const int halfSpan=(w*2+4)/5;            // ceil((w/2) / 1.25)
+  int minDeg=heading_deg - halfSpan;
+  int maxDeg=heading_deg + halfSpan;
 
   for(int deg=minDeg-(minDeg%10); deg<=maxDeg; deg+=10){
-    float dx=(deg-heading_deg)*pxPerDeg;
-    int x=(int)roundf(cx+dx);
+    int d5=(deg-heading_deg)*5;
+    int x=cx + (d5>=0 ? (d5+2)/4 : -((2-d5)/4));
     if(x<0||x>=w) continue;
 
     int ddeg=norm360(deg);
@@ -358,34 +384,34 @@ static void drawCompassTape(float heading_deg){
   int tipX=cx, tipY=yTop+h;
   tft.fillTriangle(tipX,tipY, tipX-6,tipY+8, tipX+6,tipY+8, COL_FG);
 
-  int hdgInt=norm360((int)lroundf(heading_deg));
+  int hdgInt=norm360(heading_deg);
   char hbuf[8];
-  snprintf(hbuf,sizeof(hbuf),"%03d",hdgInt);
+  fmt_u32(hbuf, hdgInt, 3);
 
-  tft.setTextSize(2);
-  tft.setTextColor(COL_FG, COL_BG);
-  tft.setCursor(tipX-18, tipY+10);
-  tft.print(hbuf);
+  const int16_t x = tipX - 18 + tft_text_draw(tipX-18, tipY+10, hbuf, 2, COL_FG, COL_BG);
 
   // Degree mark (tiny dot)
-  int16_t x = tft.getCursorX();
-  int16_t y = tft.getCursorY();
-  tft.fillCircle(x + 2, y - 6, 2, COL_FG);
+  tft.fillCircle(x + 2, tipY + 4, 2, COL_FG);
 }
+// Tape follows the interpolated heading (nav/heading.h); redrawn only when the whole degree moves
+static int tapeLastDeg = -1;
+static float cruiseHeading(){ float h = heading_at(ui.tele, uiNow); return isnan(h) ? 0.f : h; }
 static void drawCruiseStatic(){
   tft.fillScreen(COL_BG);
   drawHeaderStrip(F("Cruise"));
-  drawHeaderBadges(navValid());
-  float hdg = (isnan(tele.track_deg)? 0.f : tele.track_deg); drawCompassTape(hdg);
+  drawHeaderBadges(ui.nav_ok);
+  tapeLastDeg = (int)lroundf(cruiseHeading()); drawCompassTape(tapeLastDeg);
 }
 static void updCruise(){
-  drawHeaderBadges(navValid());
-  float hdg=(isnan(tele.track_deg)?0.f:tele.track_deg); drawCompassTape(hdg);
-  const int yText=tft.height()-22; tft.setTextColor(COL_FG, COL_BG); tft.setTextSize(2);
-  tft.setCursor(6,yText);
-  if(!isnan(tele.sog_kts)){ int skts=(int)lroundf(tele.sog_kts); tft.print(skts); tft.print("kts"); } else tft.print("---kts");
-  char buf[16]; if(!isnan(tele.alt_m)){ int ft=(int)lroundf(tele.alt_m*3.28084f); snprintf(buf,sizeof(buf),"%dft",ft); } else snprintf(buf,sizeof(buf),"---ft");
-  int tw=strlen(buf)*12; tft.setCursor(tft.width()-6-tw,yText); tft.print(buf);
+  drawHeaderBadges(ui.nav_ok);
+  const int hdg = (int)lroundf(cruiseHeading());
+  if (hdg != tapeLastDeg) { tapeLastDeg = hdg; drawCompassTape(hdg); }
+  const int yText=tft.height()-22;
+  char buf[16];
+  if(!isnan(ui.tele.sog_kts)) fmt_str(buf + fmt_i32(buf, lroundf(ui.tele.sog_kts)), "kts"); else fmt_str(buf, "---kts");
+  tft_text_draw(6, yText, buf, 2, COL_FG, COL_BG, 6);
+  if(!isnan(ui.tele.alt_m)) fmt_str(buf + fmt_i32(buf, lroundf(ui.tele.alt_m*3.28084f)), "ft"); else fmt_str(buf, "---ft");
+  tft_text_draw_right(tft.width()-6, yText, buf, 2, COL_FG, COL_BG, 6);
 }
 
 // ---------------- Traffic (bearing number removed) ----------------
@@ -395,32 +421,58 @@ static void drawGliderGlyph(int cx, int cy, uint16_t col) {
   tft.drawLine(cx, cy+5, cx+4, cy+8, col);
   tft.drawLine(cx, cy+5, cx-4, cy+8, col);
 }
-static void drawArrowOnRing(int cx, int cy, int R, float bearing_deg, uint16_t col) {
-  const int   Rbase = R + 8;
-  const float rad   = bearing_deg * 3.1415926f / 180.0f;
-
-  const float rx = cx + (Rbase) * sinf(rad);
-  const float ry = cy - (Rbase) * cosf(rad);
-
-  float vx = (float)cx - rx, vy = (float)cy - ry;
-  const float vlen = sqrtf(vx*vx + vy*vy);
-  if (vlen < 1e-3f) return;
-  vx /= vlen; vy /= vlen;
-
-  const float px = -vy, py = vx;
-
-  const float tipLen = 22.0f;
-  const float baseW  = 16.0f;
-  const float baseIn = 5.0f;
-
-  const float tx  = rx + vx * tipLen;
-  const float ty  = ry + vy * tipLen;
-  const float blx = rx + px*(baseW*0.5f) - vx*baseIn;
-  const float bly = ry + py*(baseW*0.5f) - vy*baseIn;
-  const float brx = rx - px*(baseW*0.5f) - vx*baseIn;
-  const float bry = ry - py*(baseW*0.5f) - vy*baseIn;
-
-  tft.fillTriangle((int)tx,(int)ty,(int)blx,(int)bly,(int)brx,(int)bry,col);
+// Arrow just outside the ring, pointing at the center. Q15 math: the unit vector
+// toward the center is (-sin, +cos) and its perpendicular is (-cos, -sin).
+static void arrowVerts(int cx, int cy, int R, bam16_t bearing, int v[6]) {
+  const int32_t Rbase  = R + 8;
+  const int32_t tipLen = 22;
+  const int32_t halfW  = 8;     // base width 16
+  const int32_t baseIn = 5;
+  const int32_t s = isin(bearing), c = icos(bearing);
+
+  const int32_t rx = ((int32_t)cx << 15) + Rbase * s;
+  const int32_t ry = ((int32_t)cy << 15) - Rbase * c;
+
+  v[0] = q15_round(rx - tipLen * s);
+  v[1] = q15_round(ry + tipLen * c);
+  v[2] = q15_round(rx - halfW * c + baseIn * s);
+  v[3] = q15_round(ry - halfW * s - baseIn * c);
+  v[4] = q15_round(rx + halfW * c + baseIn * s);
+  v[5] = q15_round(ry + halfW * s - baseIn * c);
+}
+static void drawArrowOnRing(int cx, int cy, int R, bam16_t bearing, uint16_t col) {
+  int v[6];
+  arrowVerts(cx, cy, R, bearing, v);
+  tft.fillTriangle(v[0],v[1],v[2],v[3],v[4],v[5],col);
+}
+// Erase an arrow drawn by drawArrowOnRing() without repainting the dial: row
+// by row, the part over the tinted disc (radius rIn) is refilled with `tint`
+// and the rest with the background. Spans are widened by a pixel to cover
+// the rasterizer's edge rounding; the caller redraws the ring outlines.
+static void eraseArrowOnRing(int cx, int cy, int R, int rIn, bam16_t bearing, uint16_t tint) {
+  int v[6];
+  arrowVerts(cx, cy, R, bearing, v);
+  const int y0 = min(v[1], min(v[3], v[5])), y1 = max(v[1], max(v[3], v[5]));
+  for (int y = y0; y <= y1; ++y) {
+    float xa = INFINITY, xb = -INFINITY;
+    for (int e = 0; e < 3; ++e) {
+      const int ax = v[2*e], ay = v[2*e+1], bx = v[(2*e+2)%6], by = v[(2*e+3)%6];
+      if (y < min(ay, by) || y > max(ay, by)) continue;
+      if (ay == by) { xa = min(xa, (float)min(ax, bx)); xb = max(xb, (float)max(ax, bx)); continue; }
+      const float x = ax + (float)(y - ay) * (bx - ax) / (float)(by - ay);
+      xa = min(xa, x); xb = max(xb, x);
+    }
+    if (xa > xb) continue;
+    const int l = (int)floorf(xa) - 1, r = (int)ceilf(xb) + 1;
+    const int dy = y - cy;
+    if (abs(dy) > rIn) { tft.drawFastHLine(l, y, r - l + 1, COL_BG); continue; }
+    const int half = (int)sqrtf((float)(rIn*rIn - dy*dy));
+    const int dl = max(l, cx - half), dr = min(r, cx + half);   // part over the disc
+    if (dl > dr) { tft.drawFastHLine(l, y, r - l + 1, COL_BG); continue; }
+    if (l < dl)  tft.drawFastHLine(l, y, dl - l, COL_BG);
+    tft.drawFastHLine(dl, y, dr - dl + 1, tint);
+    if (dr < r)  tft.drawFastHLine(dr + 1, y, r - dr, COL_BG);
+  }
 }
 static void drawVertIndicatorRight(int x, int y, bool above, bool below, uint16_t col){
   if (above){
@@ -431,91 +483,125 @@ static void drawVertIndicatorRight(int x, int y, bool above, bool below, uint16_
     tft.fillCircle(x, y, 5, col);
   }
 }
-struct TrafficDrawCache { bool alive; int alarm; float bearing_deg; float dist_m; float relV_m; uint32_t since; };
-static TrafficDrawCache trafLast = {false, 0, NAN, NAN, NAN, 0};
+struct TrafficDrawCache {
+  bool alive; int alarm; float bearing_deg; float dist_m; float relV_m; uint32_t since;
+  bam16_t arrow; int16_t dotX, dotY; int8_t vert;   // what is on glass, for partial erase
+  char text[40];                                    // top line as last printed
+};
+static TrafficDrawCache trafLast = {false, 0, NAN, NAN, NAN, 0, 0, 0, 0, 0, ""};
 
 static void drawTrafficStatic(){
   tft.fillScreen(COL_BG);
   drawHeaderStrip(F("Traffic"));
   tft.drawFastHLine(0,16,tft.width(),COL_ACCENT);
 }
+// The dial is repainted only when the target appears, goes or changes level
+// (the tint changes). While a target is dead-reckoned, only what moved is
+// erased: the top line if its text changed, the old arrow and dot, and the
+// vertical indicator if it flipped.
 static void renderTrafficDynamic(bool force){
   const int cx = tft.width()/2 - 12;
   const int cy = 84;
   const int R  = 38;
+  const int vx = cx + R + 22;
+
+  const bool alive = ui.alert.active && (uiNow - ui.alert.since) < ALERT_HOLD_MS;
 
-  const bool alive = alert.active && (millis() - alert.since) < ALERT_HOLD_MS;
+  // Dead-reckon the target between 1 Hz fixes so the dot moves at the frame rate
+  float relN, relE, relV;
+  traffic_extrapolate(ui.alert, uiNow, relN, relE, relV);
+  const float   dist_m  = sqrtf(relN*relN + relE*relE);
+  const bam16_t bearing = iatan2((int32_t)lroundf(relE), (int32_t)lroundf(relN));
+  const float   bearing_deg = bam_to_deg(bearing);
 
   bool changed = force ||
                  (alive != trafLast.alive) ||
-                 (alive && (alert.alarm != trafLast.alarm ||
-                            alert.since != trafLast.since ||
-                            alert.bearing_deg != trafLast.bearing_deg ||
-                            alert.dist_m != trafLast.dist_m ||
-                            alert.relV_m != trafLast.relV_m));
+                 (alive && (ui.alert.alarm != trafLast.alarm ||
+                            ui.alert.since != trafLast.since ||
+                            bearing_deg != trafLast.bearing_deg ||
+                            dist_m != trafLast.dist_m ||
+                            relV != trafLast.relV_m));
   if(!changed) return;
 
-  tft.fillRect(0,17, tft.width(), tft.height()-17, COL_BG);
-  drawHeaderBadges(navValid());
-
-  tft.setTextSize(1);
-  tft.setTextColor(COL(220,220,220), COL_BG);
-
-  if (!alive) {
-    tft.setCursor(6,18); tft.print(F("No recent targets"));
-  } else {
-    float dist_km = alert.dist_m / 1000.0f;
-    char  distbuf[16]; dtostrf(dist_km, 0, 1, distbuf);
-    tft.setCursor(6,18); tft.print(distbuf); tft.print(" km");
-
-    // Center: relative vertical (ft)
-    char vbuf[18];
-    int dAlt_ft = (int)lroundf(alert.relV_m * 3.28084f);
-    snprintf(vbuf, sizeof(vbuf), "dAlt %d ft", dAlt_ft);
-    int tw_v = (int)strlen(vbuf) * 6;
-    int x_v  = max(6, (tft.width() - tw_v) / 2);
-    tft.setCursor(x_v, 18);
-    tft.print(vbuf);
-
-    // Right-hand bearing numeric removed by request; arrow remains the visual indicator.
-  }
+  const bool full = force || alive != trafLast.alive || (alive && ui.alert.alarm != trafLast.alarm);
 
   uint16_t tint = COL_BG;
   if (alive) {
-    if      (alert.alarm >= 3) tint = TINT_L3;
-    else if (alert.alarm == 2) tint = TINT_L2;
+    if      (ui.alert.alarm >= 3) tint = TINT_L3;
+    else if (ui.alert.alarm == 2) tint = TINT_L2;
     else                       tint = TINT_L1;
   }
   const uint16_t fg = COL_FG;
-  for (int i=0;i<2;i++) tft.drawCircle(cx, cy, R-i, fg);
-  if (alive){
-    tft.fillCircle(cx, cy, R-3, tint);
-    for (int i=0;i<2;i++) tft.drawCircle(cx, cy, R-i, fg);
+
+  // Top line: distance, relative vertical (ft), time to CPA
+  char text[40] = {0};
+  int  xV = 0, xT = 0;
+  char* pV = nullptr; char* pT = nullptr;
+  if (!alive) fmt_str(text, "No recent targets");
+  else {
+    char* p = text;
+    p += fmt_fixed(p, lroundf(dist_m / 100.0f), 1); p += fmt_str(p, " km") + 1;
+    pV = p;
+    p += fmt_str(p, "dAlt "); p += fmt_i32(p, (int)lroundf(relV * 3.28084f)); p += fmt_str(p, " ft") + 1;
+    xV = max(6, (tft.width() - (int)strlen(pV) * 6) / 2);
+    // Right-hand bearing numeric removed by request; arrow remains the visual indicator.
+    // Converging target: time to closest approach in its place
+    pT = p; *pT = 0;
+    if (ui.alert.tcpa_s >= 0.0f) {
+      fmt_str(p + fmt_i32(p, lroundf(max(0.0f, ui.alert.tcpa_s - (uiNow - ui.alert.since) / 1000.0f))), "s");
+      xT = tft.width() - 6 - (int)strlen(pT) * 6;
+    }
+  }
+  const bool textChanged = full || memcmp(text, trafLast.text, sizeof(text)) != 0;
+
+  if (full) {
+    tft.fillRect(0,17, tft.width(), tft.height()-17, COL_BG);
+  } else if (alive) {
+    eraseArrowOnRing(cx, cy, R, R-3, trafLast.arrow, tint);
+    tft.fillCircle(trafLast.dotX, trafLast.dotY, 3, tint);
+  }
+  if (textChanged && !full) tft.fillRect(0, 18, tft.width(), 8, COL_BG);
+  drawHeaderBadges(ui.nav_ok);
+
+  if (textChanged) {
+    tft.setTextSize(1);
+    tft.setTextColor(COL(220,220,220), COL_BG);
+    tft.setCursor(6,18); tft.print(text);
+    if (pV) { tft.setCursor(xV, 18); tft.print(pV); }
+    if (pT && *pT) { tft.setCursor(xT, 18); tft.print(pT); }
   }
-  drawGliderGlyph(cx, cy, fg);
 
+  for (int i=0;i<2;i++) tft.drawCircle(cx, cy, R-i, fg);
+  if (full && alive) tft.fillCircle(cx, cy, R-3, tint);
+  drawGliderGlyph(cx, cy, fg);                       // an erased dot may have clipped it
+
+  int8_t vert = 0;
   if (alive){
-    drawArrowOnRing(cx, cy, R, alert.bearing_deg, fg);
-    const float maxRange = 1500.0f;
-    const float clamp    = (alert.dist_m > maxRange) ? (maxRange/alert.dist_m) : 1.0f;
-    const float r_pix    = (alert.dist_m * clamp) * ((R-6)/maxRange);
-    const float ang      = alert.bearing_deg * 3.1415926f / 180.0f;
-    const int   tx       = cx + (int)roundf(r_pix * sinf(ang));
-    const int   ty       = cy - (int)roundf(r_pix * cosf(ang));
+    drawArrowOnRing(cx, cy, R, bearing, fg);
+    const float   maxRange = 1500.0f;
+    const int32_t r_pix    = lroundf(min(dist_m, maxRange) * ((R-6)/maxRange));
+    const int     tx       = cx + q15_mul(r_pix, isin(bearing));
+    const int     ty       = cy - q15_mul(r_pix, icos(bearing));
     tft.fillCircle(tx, ty, 3, fg);
+    trafLast.dotX = (int16_t)tx; trafLast.dotY = (int16_t)ty;
 
-    const float dAlt_ft = alert.relV_m * 3.28084f;
-    const bool above = dAlt_ft >  200.0f;
-    const bool below = dAlt_ft < -200.0f;
-    drawVertIndicatorRight(cx + R + 22, cy, above, below, fg);
+    const float dAlt_ft = relV * 3.28084f;
+    vert = dAlt_ft > 200.0f ? 1 : dAlt_ft < -200.0f ? -1 : 0;
+    // The arrow erase can clip the indicator's left edge, so it is always redrawn
+    if (!full && vert != trafLast.vert) tft.fillRect(vx - 9, cy - 16, 19, 33, COL_BG);
+    drawVertIndicatorRight(vx, cy, vert > 0, vert < 0, fg);
   }
 
   trafLast.alive       = alive;
-  trafLast.alarm       = alert.alarm;
-  trafLast.bearing_deg = alert.bearing_deg;
-  trafLast.dist_m      = alert.dist_m;
-  trafLast.relV_m      = alert.relV_m;
-  trafLast.since       = alert.since;
+  trafLast.alarm       = ui.alert.alarm;
+  trafLast.bearing_deg = bearing_deg;
+  trafLast.dist_m      = dist_m;
+  trafLast.relV_m      = relV;
+  trafLast.since       = ui.alert.since;
+  trafLast.arrow       = bearing;
+  trafLast.vert        = vert;
+  memcpy(trafLast.text, text, sizeof(text));
+  if (alive) prof_trace(PROF_LAT_GLASS, ui.alert.rx_us);   // pixels are on glass once the SPI writes return
 }
 
 // ---------------- Landing / Landed ----------------
@@ -528,18 +614,16 @@ static void drawLandingStatic(){
   tft.setCursor(6,64); tft.print(F("Altitude (ft)"));
 }
 static void updLanding(){
-  tft.setTextColor(COL_FG, COL_BG);
-  tft.setTextSize(3);
-  int xv = 6;
-  tft.setCursor(xv,38);
-  if(!isnan(tele.sog_kts)){ int kts=(int)lroundf(tele.sog_kts); tft.print(kts); tft.print("kts"); } else tft.print("---kts");
-  tft.setCursor(xv,74);
-  if(!isnan(tele.alt_m)){
-    int alt_ft = (int)lroundf(tele.alt_m * 3.28084f);
-    tft.print(alt_ft); tft.print("ft");
+  const int xv = 6;
+  char buf[16];
+  if(!isnan(ui.tele.sog_kts)) fmt_str(buf + fmt_i32(buf, lroundf(ui.tele.sog_kts)), "kts"); else fmt_str(buf, "---kts");
+  tft_text_draw(xv, 38, buf, 3, COL_FG, COL_BG, 7);
+  if(!isnan(ui.tele.alt_m)){
+    fmt_str(buf + fmt_i32(buf, lroundf(ui.tele.alt_m * 3.28084f)), "ft");
   } else {
-    tft.print("---ft");
+    fmt_str(buf, "---ft");
   }
+  tft_text_draw(xv, 74, buf, 3, COL_FG, COL_BG, 7);
 }
 static void drawLandedStatic(){
   tft.fillScreen(COL_BG);
@@ -551,29 +635,26 @@ static void drawLandedStatic(){
   tft.setCursor(6,104); tft.print(F("Alerts"));
 }
 static void updLanded(){
-  tft.setTextColor(COL_FG, COL_BG);
-  tft.setTextSize(3);
-  uint32_t ms = app_last_flight_duration_ms();
+  uint32_t ms = ui.flight_ms;
   uint32_t sec = ms / 1000u;
   uint32_t hh = sec / 3600u;
   uint32_t mm = (sec % 3600u) / 60u;
-  char dur[8]; snprintf(dur, sizeof(dur), "%lu:%02lu", (unsigned long)hh, (unsigned long)mm);
-  tft.setCursor(6,34); tft.print(dur);
+  char dur[12]; { char* p = dur; p += fmt_u32(p, hh); p += fmt_str(p, ":"); fmt_u32(p, mm, 2); }
+  tft_text_draw(6, 34, dur, 3, COL_FG, COL_BG, 6);
 
-  int uh = tele.utc_hour, um = tele.utc_min;
+  int uh = ui.tele.utc_hour, um = ui.tele.utc_min;
   char utcbuf[8];
-  if (uh>=0 && um>=0) snprintf(utcbuf, sizeof(utcbuf), "%02d:%02d", uh, um);
-  else                snprintf(utcbuf, sizeof(utcbuf), "--:--");
-  tft.setCursor(6,74); tft.print(utcbuf);
+  if (uh>=0 && um>=0) { char* p = utcbuf; p += fmt_u32(p, uh, 2); p += fmt_str(p, ":"); fmt_u32(p, um, 2); }
+  else                fmt_str(utcbuf, "--:--");
+  tft_text_draw(6, 74, utcbuf, 3, COL_FG, COL_BG);
 
-  tft.setTextSize(2);
-  uint16_t nAlerts = app_last_flight_alerts();
-  tft.setCursor(6,110); tft.print(nAlerts);
+  char nbuf[8]; fmt_u32(nbuf, ui.flight_alerts);
+  tft_text_draw(6, 110, nbuf, 2, COL_FG, COL_BG, 5);
 }
 
 // ---------------- Page router ----------------
 static void drawPage(){
-  switch(g_current_page){
+  switch(ui.page){
     case PAGE_BOOT:
       if(!pageDrawn[PAGE_BOOT]){ drawBootStatic(); pageDrawn[PAGE_BOOT]=true; }
       updBoot(); break;
@@ -581,8 +662,9 @@ static void drawPage(){
       if(!pageDrawn[PAGE_COMPASS]){ drawCruiseStatic(); pageDrawn[PAGE_COMPASS]=true; }
       updCruise(); break;
     case PAGE_TRAFFIC:
-      if(!pageDrawn[PAGE_TRAFFIC]){ drawTrafficStatic(); pageDrawn[PAGE_TRAFFIC]=true; }
-      renderTrafficDynamic(false); break;
+    { bool fresh = !pageDrawn[PAGE_TRAFFIC];
+      if(fresh){ drawTrafficStatic(); pageDrawn[PAGE_TRAFFIC]=true; }
+      renderTrafficDynamic(fresh); } break;
     case PAGE_LANDING:
       if(!pageDrawn[PAGE_LANDING]){ drawLandingStatic(); pageDrawn[PAGE_LANDING]=true; }
       updLanding(); break;
@@ -599,45 +681,124 @@ static void tele_init_defaults(){
   tele.sog_kts = NAN; tele.track_deg = NAN;
   tele.last_nmea_ms = 0;
   tele.vs_ms = 0;
-  tele.utc_hour = -1; tele.utc_min = -1;
+  tele.utc_hour = -1; tele.utc_min = -1; tele.utc_epoch = 0;
 }
 
 // ---------------- Sensors ----------------
-static void updateBMP(){
-  if(!tele.bmp_ok) return;
-  float seaLevel = qnh_hPa;
+// The sensor task owns I2C and only posts raw samples; altitude is derived on
+// the control task so a QNH change never needs a bus read. t_ms is when the
+// BMP280 finished the conversion (drivers/baro.h).
+struct BaroSample { uint32_t t_ms; float tC; float p_hPa; };
+static QueueHandle_t qBaro = nullptr;
+static float    lastAlt  = NAN;
+static uint32_t lastAltT = 0;
+
+static inline float baro_alt_m(float p_hPa, float qnh){
+  return 44330.0f * (1.0f - powf(p_hPa / qnh, 0.1903f));   // same model as Adafruit_BMP280
+}
+// Inverse: the QNH at which p_hPa reads alt_m
+static inline float baro_qnh_for(float p_hPa, float alt_m){
+  return p_hPa / powf(1.0f - alt_m / 44330.0f, 1.0f / 0.1903f);
+}
 
-  float tC=bmp.readTemperature();
-  float pPa=bmp.readPressure();
-  if(!isnan(tC) && !isnan(pPa)){
-    tele.tC=tC; tele.p_hPa=pPa/100.0f; tele.alt_m=bmp.readAltitude(seaLevel);
+static void baro_apply(const BaroSample& b){
+  tele.tC = b.tC; tele.p_hPa = b.p_hPa; tele.alt_m = baro_alt_m(b.p_hPa, qnh_hPa);
+  // Initial baseline capture was moved to boot auto-anchor logic.
+  // VS smoothed over BARO_VS_TAU_S whatever the profile's sample rate
+  if(!isnan(lastAlt)){
+    float dt=(b.t_ms-lastAltT)/1000.0f;
+    if(dt>0.001f) tele.vs_ms += (dt/(BARO_VS_TAU_S+dt)) * ((tele.alt_m-lastAlt)/dt - tele.vs_ms);
+  }
+  lastAlt=tele.alt_m; lastAltT=b.t_ms;
+}
+
+// Re-derive altitude after a QNH change (no VS spike)
+static void baro_recompute(){
+  if(isnan(tele.p_hPa)) return;
+  tele.alt_m = baro_alt_m(tele.p_hPa, qnh_hPa);
+  lastAlt = tele.alt_m;
+}
 
-    // Initial baseline capture was moved to boot auto-anchor logic.
+static void sensor_task(void*){
+  for(;;){
+    const uint32_t ready = baro_wait();      // profile switch, then sleep until the conversion is done
+    float tC, pPa;
+    {
+      PROF_SCOPE(PROF_BARO);
+      baro_sample(tC, pPa);
+    }
+    if(!isnan(tC) && !isnan(pPa)){
+      BaroSample b = { ready ? ready : millis(), tC, pPa/100.0f };
+      xQueueSend(qBaro, &b, 0);
+    }
   }
-  uint32_t now=millis();
-  static float lastAlt = NAN; static uint32_t lastAltT=0;
-  if(!isnan(tele.alt_m)){
-    if(!isnan(lastAlt)){ float dt=(now-lastAltT)/1000.0f; if(dt>0.001f) tele.vs_ms=(tele.alt_m-lastAlt)/dt; }
-    lastAlt=tele.alt_m; lastAltT=now;
+}
+
+// Barometer profile for the flight phase: fast from the takeoff roll through
+// the climb-out and below BARO_APPROACH_FT, moderate in cruise, forced-mode
+// 1 Hz on the ground. Faster at once; slower only after BARO_RELAX_MS.
+static void baro_select(uint32_t now){
+  extern AppState g_state;
+  static uint32_t airborne_ms = 0, relax_ms = 0;
+  const bool inAir = (g_state == ST_FLYING || g_state == ST_ALERT || g_state == ST_LANDING);
+  if (!inAir) airborne_ms = 0;
+  else if (!airborne_ms) airborne_ms = now | 1;
+
+  const float agl = (baselineSet && !isnan(tele.alt_m)) ? m_to_ft(tele.alt_m - baselineAlt_m) : NAN;
+  BaroProfile p;
+  if (g_state == ST_LANDING) {
+    p = BARO_FAST;
+  } else if (inAir) {
+    p = (now - airborne_ms < BARO_CLIMBOUT_MS || (!isnan(agl) && agl < BARO_APPROACH_FT)) ? BARO_FAST : BARO_CRUISE;
+  } else {
+    const bool rolling = !isnan(tele.sog_kts) && tele.sog_kts >= BARO_ROLL_KTS && now - tele.last_nmea_ms < 3000;
+    // Without nav there is no ground speed: a winch or aerotow launch shows up
+    // as a climb first, and the baro takeoff fallback needs the fast samples.
+    const bool climbing = !navValid()
+                       && (tele.vs_ms >= BARO_CLIMB_MS || (!isnan(agl) && agl >= BARO_CLIMB_FT));
+    p = (rolling || climbing) ? BARO_FAST : BARO_GROUND;
   }
+
+  const BaroProfile cur = baro_profile();
+  if (p >= cur) { relax_ms = 0; if (p != cur) baro_request(p); return; }
+  if (!relax_ms) relax_ms = now | 1;
+  if (now - relax_ms >= BARO_RELAX_MS) { relax_ms = 0; baro_request(p); }
+}
+
+// ---------------- Settings persistence ----------------
+// g_cfg belongs to the control task, which must never wait on an NVS commit:
+// it only marks the settings dirty, and control_tick() hands a copy to loop(),
+// which does the flash write. Several changes in a row coalesce into one commit.
+static bool settingsDirty = false;                    // control task
+static SpscQueue<HaloSettings, 2> settingsOut;        // control task -> loop()
+
+static void settings_persist(){ settingsDirty = true; }
+
+static void settings_handoff(){
+  if (settingsDirty && settingsOut.push(g_cfg)) settingsDirty = false;   // full: retry next tick
+}
+
+static void settings_service(){
+  HaloSettings s;
+  bool any = false;
+  while (settingsOut.pop(s)) any = true;
+  if (any && !nvs_save_settings(s)) Serial.println("[CFG] NVS save FAILED");
 }
 
 // ---------------- App hooks for BLE persistence/hot-switch ----------------
-void halo_set_volume_runtime_and_persist(uint8_t vol0_30){
+// apply_* change runtime + g_cfg only; callers persist once with settings_persist().
+static void apply_volume(uint8_t vol0_30){
   df_volume = constrain(vol0_30, 0, 30);
   g_cfg.volume0_30 = df_volume;
-  nvs_save_settings(g_cfg);
-
-  df_set_volume_immediate(df_volume);
-  Serial.printf("[AUDIO] volume now %u (persisted)\n", (unsigned)df_volume);
+  dfp_set_volume(df_volume);
+  HLOGI("[AUDIO] volume now %u\n", (unsigned)df_volume);
 }
-void halo_set_qnh_runtime_and_persist(uint16_t hpa){
-  qnh_hPa = (float)hpa;
+static void apply_qnh(float hpa){
+  qnh_hPa = hpa;
   g_cfg.qnh_hPa = qnh_hPa;
-  nvs_save_settings(g_cfg);
 
   // Recompute altitude at the new QNH
-  updateBMP();
+  baro_recompute();
 
   // If not airborne, anchor baseline so AGL ≈ 0 (prevents FSM misfires)
   extern AppState g_state;
@@ -647,8 +808,7 @@ void halo_set_qnh_runtime_and_persist(uint16_t hpa){
     baselineSet   = true;
     g_cfg.baselineAlt_m = baselineAlt_m;
     g_cfg.baselineSet   = true;
-    nvs_save_settings(g_cfg);
-    Serial.printf("[QNH] baseline anchored to %.2fm (AGL stabilized)\n", baselineAlt_m);
+    HLOGI("[QNH] baseline anchored to %.2fm (AGL stabilized)\n", baselineAlt_m);
 
     // *** NEW *** arm AGL fallback takeoff after a ground QNH adjust
     app_preflight_mark_baseline_ok();
@@ -656,21 +816,43 @@ void halo_set_qnh_runtime_and_persist(uint16_t hpa){
 
   // UI will pick up qnh_hPa on the next BOOT tick
 }
-void halo_set_elev_runtime_and_persist(uint16_t feet){
-  airfieldElev_ft = (float)feet;
+static void apply_elev(float feet){
+  airfieldElev_ft = feet;
   g_cfg.airfieldElev_ft = airfieldElev_ft;
-  nvs_save_settings(g_cfg);
 }
-void halo_set_datasource_and_baud(bool isSoftRF, uint8_t baudIndex){
+
+// Airfield auto-setup: stationary on the ground with a fresh fix near a known
+// field, take its elevation and set QNH so the baro altitude reads it; the
+// ground QNH path then re-anchors the AGL baseline. Once per ground phase.
+static bool     fieldSet    = false;
+static uint32_t fieldTry_ms = 0;
+static void airfield_autoset(uint32_t now){
+  extern AppState g_state;
+  if (g_state != ST_PREFLIGHT && g_state != ST_LANDED) { fieldSet = false; fieldTry_ms = 0; return; }
+  if (fieldSet || !airfields_count() || (fieldTry_ms && now - fieldTry_ms < AIRFIELD_RETRY_MS)) return;
+  if (!tele.pos_ms || now - tele.pos_ms > AIRFIELD_POS_AGE_MS) return;
+  if (isnan(tele.sog_kts) || tele.sog_kts > AIRFIELD_MAX_KTS) return;
+  fieldTry_ms = now;
+
+  float d = 0;
+  const AssetAirfield* f = airfield_nearest(tele.lat_e7, tele.lon_e7, AIRFIELD_MATCH_M, &d);
+  if (!f) return;
+  fieldSet = true;
+  apply_elev(max(0, (int)f->elev_ft));
+  if (!isnan(tele.p_hPa)) {
+    const float qnh = baro_qnh_for(tele.p_hPa, f->elev_ft / 3.28084f);
+    if (qnh >= 800.0f && qnh <= 1200.0f) apply_qnh(qnh);
+  }
+  settings_persist();
+  HLOGI("[AIRFIELD] at %.6s (%.0f m): elevation %d ft, QNH %.1f hPa\n", f->ident, d, (int)f->elev_ft, qnh_hPa);
+}
+static void apply_datasource(bool isSoftRF, uint8_t baudIndex){
   g_cfg.data_source = isSoftRF ? HALO_SRC_SOFTRF : HALO_SRC_FLARM;   // enum-safe
-  nvs_save_settings(g_cfg);
 
   uint32_t baud = (baudIndex==0) ? 19200u : 38400u;
   halo_apply_nav_baud(baud);   // re-open UART2
 
-  // Drain any stale bytes and force nav age to "unknown"
-  delay(20);
-  while (FLARM.available()) (void)FLARM.read();
+  // Nav task drops stale bytes on reopen; force nav age to "unknown"
   tele.last_nmea_ms = 0;
 
   // Arm auto-baud recovery (try the other baud if no frames arrive)
@@ -680,99 +862,186 @@ void halo_set_datasource_and_baud(bool isSoftRF, uint8_t baudIndex){
 
   ui_markAllUndrawn();
 
-  Serial.printf("[NAV] source=%s, baud=%lu (flushed; awaiting fresh NMEA)\n",
+  HLOGI("[NAV] source=%s, baud=%lu (flushed; awaiting fresh NMEA)\n",
                 isSoftRF ? "SoftRF" : "FLARM", (unsigned long)baud);
 }
 
-void halo_apply_nav_baud(uint32_t baud){
-  g_nav_baud = baud;
-  nav_begin(FLARM, FLARM_RX_PIN, g_nav_baud); // re-open Serial2 at new baud
-  Serial.printf("[NAV] UART reinit @ %lu\n", (unsigned long)g_nav_baud);
+void halo_set_volume_runtime_and_persist(uint8_t vol0_30){
+  apply_volume(vol0_30);
+  settings_persist();
+}
+void halo_set_qnh_runtime_and_persist(uint16_t hpa){
+  apply_qnh((float)hpa);
+  settings_persist();
+}
+void halo_set_elev_runtime_and_persist(uint16_t feet){
+  apply_elev((float)feet);
+  settings_persist();
+}
+void halo_set_datasource_and_baud(bool isSoftRF, uint8_t baudIndex){
+  apply_datasource(isSoftRF, baudIndex);
+  settings_persist();
 }
 
-// ---------------- Setup / Loop ----------------
-void setup(){
-  Serial.begin(115200);
-  uint32_t t0=millis(); while(!Serial && millis()-t0<1000){ delay(10); }
-
-  // Display / backlight
-  ledcSetup(BL_CH, BL_FREQ, BL_BITS); ledcAttachPin(TFT_BL, BL_CH); setBrightness(255);
-  SPI.begin(TFT_SCLK, TFT_MISO, TFT_MOSI, TFT_CS);
-  tft.initR(INITR_GREENTAB); tft.setRotation(1); tft.setSPISpeed(12000000);
-  tft.fillScreen(COL_BG); tft.setTextColor(COL_FG); tft.setTextSize(1);
-
-  // Telemetry defaults & splash
-  tele_init_defaults();
-  splash = SPLASH_START; splash_t=millis();
+void halo_get_config(HaloConfig& out){
+  out.mask     = CFG_ALL;
+  out.qnh_dhPa = (uint16_t)lroundf(qnh_hPa * 10.0f);
+  out.elev_ft  = (uint16_t)max(0.0f, airfieldElev_ft);
+  out.volume   = df_volume;
+  out.source   = (uint8_t)g_cfg.data_source;
+  out.baud_idx = (g_nav_baud == 38400u) ? 1 : 0;
+}
 
-  // I2C / BMP280
-  Wire.begin(I2C_SDA, I2C_SCL, 100000);
-  bool found=false; uint8_t addr=0x76;
-  for(uint8_t a:{(uint8_t)0x76,(uint8_t)0x77}){ Wire.beginTransmission(a); if(Wire.endTransmission()==0){ addr=a; found=true; break; } }
-  if(found && bmp.begin(addr)){
-    bmp.setSampling(Adafruit_BMP280::MODE_NORMAL,
-                    Adafruit_BMP280::SAMPLING_X8,
-                    Adafruit_BMP280::SAMPLING_X16,
-                    Adafruit_BMP280::FILTER_X16,
-                    Adafruit_BMP280::STANDBY_MS_63);
-    tele.bmp_ok=true;
+// Apply a validated subset in one go: values first, then a single NVS commit
+void halo_apply_config(const HaloConfig& in){
+  HaloConfig cur; halo_get_config(cur);
+
+  if (in.mask & CFG_VOLUME) apply_volume(in.volume);
+  if (in.mask & CFG_ELEV)   apply_elev((float)in.elev_ft);
+  if (in.mask & CFG_QNH)    apply_qnh(in.qnh_dhPa / 10.0f);
+  if (in.mask & (CFG_SOURCE | CFG_BAUD)) {
+    const uint8_t src = (in.mask & CFG_SOURCE) ? in.source : cur.source;
+    // New source without an explicit baud: use that source's usual rate
+    const uint8_t idx = (in.mask & CFG_BAUD) ? in.baud_idx
+                      : (src != cur.source)  ? (uint8_t)(src ? 1 : 0) : cur.baud_idx;
+    if (src != cur.source || idx != cur.baud_idx) apply_datasource(src != 0, idx);
   }
+  settings_persist();
+  HLOGI("[CFG] applied mask=0x%02X (save queued)\n", (unsigned)in.mask);
+}
 
-  // Strobe GPIO
-  pinMode(STROBE_PIN, OUTPUT); strobeApply(false); strobeSet(120,2000); strobeEnable(false);
-
-  // NVS
-  nvs_init();
-  nvs_load_settings(g_cfg);
-
-  // Apply to runtime
-  qnh_hPa         = g_cfg.qnh_hPa;
-  airfieldElev_ft = g_cfg.airfieldElev_ft;
-  df_volume       = g_cfg.volume0_30;
-  baselineSet     = g_cfg.baselineSet;
-  baselineAlt_m   = g_cfg.baselineAlt_m;
-
-  // Choose nav baud from data source (0=FLARM, 1=SoftRF)
-  g_nav_baud = (g_cfg.data_source != 0) ? 38400u : 19200u;
+void halo_apply_nav_baud(uint32_t baud){
+  g_nav_baud = baud;
+  nav_begin(FLARM, FLARM_RX_PIN, g_nav_baud); // re-open Serial2 at new baud
+  HLOGI("[NAV] UART reinit @ %lu\n", (unsigned long)g_nav_baud);
 }
 
-void loop(){
-  uint32_t now=millis();
+// ---------------- Tasks ----------------
+static TaskHandle_t  controlTask = nullptr;
+static QueueHandle_t qKeys       = nullptr;
+
+// Single writer of the state store: commit once per control tick
+static void state_publish(){
+  static HaloState st;
+  st.tele          = tele;
+  st.alert         = alert;
+  st.baselineSet   = baselineSet;
+  st.baselineAlt_m = baselineAlt_m;
+  st.qnh_hPa       = qnh_hPa;
+  st.elev_ft       = airfieldElev_ft;
+  st.volume        = df_volume;
+  st.state         = g_state;
+  st.strobe_level  = (uint8_t)app_strobe_level();
+  st.strobe_on     = strobe_enabled;
+  st.nav_ok        = navValid();
+  st.page          = g_current_page;
+  st.redraw        = uiRedraw;
+  st.flight_ms     = app_last_flight_duration_ms();
+  st.flight_alerts = app_last_flight_alerts();
+  state_commit(st);
+}
 
-  // SPLASH / VERSION
-  if(splash!=SPLASH_DONE){
-    splash_tick();
-    if(splash==SPLASH_DONE){
-      // Bring systems up
-      dfp_begin(DFSerial, DF_TX_PIN, DF_BUSY_PIN, DF_BAUD, df_volume);
-      nav_begin(FLARM, FLARM_RX_PIN, g_nav_baud);
-      app_fsm_init();
-      ui_set_page(PAGE_BOOT);
-      bootShownSince_ms = millis();
-      Serial.println("[BOOT] init complete");
+// Console keys that touch app state (run on the control task)
+static void handle_key(int ch){
+  switch (ch) {
+    case 'J':
+      HLOGI("[KEY] J -> play takeoff prompt\n");
+      dfp_stop_and_flush();
+      dfp_play_filename(prompt_track(PROMPT_TAKEOFF));
+      break;
 
-      // DF volume to saved level, then boot chime
-      delay(200);
-      df_set_volume_immediate(df_volume);
-      delay(40);
+    case 'T': {
+      HLOGI("[KEY] T -> DEMO: force FLYING\n");
+      tele.sog_kts   = 25.0f;
+      tele.track_deg = 0.0f;
+      app_demo_force_flying();
+    } break;
+
+    case 'L': {
+      HLOGI("[KEY] L -> DEMO: landing\n");
+      if (!baselineSet && !isnan(tele.alt_m)) { baselineAlt_m = tele.alt_m; baselineSet=true; }
+      tele.sog_kts = 0.0f;
+      app_demo_force_landing();
+    } break;
+
+    case 'R': {
+      if (!isnan(tele.alt_m)) {
+        baselineAlt_m = tele.alt_m; baselineSet = true;
+        g_cfg.baselineSet = baselineSet;
+        g_cfg.baselineAlt_m = baselineAlt_m;
+        settings_persist();
+        HLOGI("[KEY] R -> baselineAlt_m=%.1f m (save queued)\n", baselineAlt_m);
+      } else HLOGI("[KEY] R -> cannot set baseline (alt_m is NaN)\n");
+    } break;
+
+    case '1':
+    case '2':
+    case '3': {
+      int lvl = ch - '0';
+      HLOGI("[KEY] %c -> DEMO alert L%d\n", ch, lvl);
+
+      alert.active = true;
+      alert.since  = millis();
+      alert.alarm  = lvl;
+
+      alert.relN_m = 500;
+      alert.relE_m = 866;
+      alert.relV_m = (lvl==1 ? 0 : (lvl==2 ? +70 : -70));
+      alert.dist_m = sqrtf(alert.relN_m*alert.relN_m + alert.relE_m*alert.relE_m);
+      alert.bearing_deg = bam_to_deg(iatan2((int32_t)alert.relE_m, (int32_t)alert.relN_m));
+      alert.id     = 0;
+      alert.vN_ms  = alert.vE_ms = alert.vV_ms = 0.0f;
+      alert.tcpa_s = -1.0f; alert.cpa_m = alert.dist_m;
+
+      ui_set_page(PAGE_TRAFFIC);
+
+      uint16_t vtrk;
+      float dAlt_ft = alert.relV_m * 3.28084f;
+      if (dAlt_ft >  200.0f) vtrk = prompt_track(PROMPT_HIGH); else if (dAlt_ft < -200.0f) vtrk = prompt_track(PROMPT_LOW); else vtrk = prompt_track(PROMPT_LEVEL);
       dfp_stop_and_flush();
-      dfp_play_filename(1);
+      dfp_play_filename(vtrk);
+      dfp_play_filename(prompt_clock_track(2));
+    } break;
 
-      trafLast = {false,0,NAN,NAN,NAN,0};
-      bleInit();
+    case 'C': {
+      HLOGI("[KEY] C -> HARD RESET to BOOT\n");
+      bleCancelTests();
+      dfp_stop_and_flush();
+      alert = {};
+      strobeEnable(false);
+      app_fsm_init();
+      ui_markAllUndrawn();
+      ui_set_page(PAGE_BOOT);
+      navWasValid = false;   // so we’ll chime again when nav becomes valid next time
 
-      // *** NEW *** schedule boot auto-anchor if nav is invalid initially
+      // *** NEW *** also reset auto-anchor so we can zero AGL again if needed
       bootBaselineDone     = false;
-      bootBaselineDeadline = millis() + 10000; // ~10 s after init
-    }
-    strobeTickSimple();
-    dfp_tick();
-    return;
+      bootBaselineDeadline = millis() + 10000;
+    } break;
+
+    default:
+      HLOGI("[KEY] unhandled: 0x%02X\n", (unsigned)ch);
+      break;
   }
+}
 
-  // cadence
-  if(now-lastSensor>=250){ updateBMP(); lastSensor=now; }
-  nav_tick();
+// FSM/alerting: everything that reads or writes tele/alert/g_state runs here
+// Boot milestones (millis since reset): control running, first valid nav fix, BLE up
+static uint32_t bootControlMs = 0, bootReadyMs = 0;
+static volatile uint32_t bootBleMs = 0;
+
+static void control_tick(uint32_t now){
+  PROF_MARK(PROF_CONTROL_PERIOD);
+  PROF_SCOPE(PROF_CONTROL);
+  if (!bootControlMs) bootControlMs = now;
+  BaroSample b;
+  while (xQueueReceive(qBaro, &b, 0) == pdTRUE) baro_apply(b);
+  { PROF_SCOPE(PROF_NAV_PARSE); nav_tick(); }
+  if (!bootReadyMs && navValid()) {             // a fix, not merely bytes on the UART
+    bootReadyMs = now;
+    HLOGI("[BOOT] ready: nav valid at %lu ms (control up at %lu ms)\n",
+          (unsigned long)bootReadyMs, (unsigned long)bootControlMs);
+  }
 
   // *** NEW *** Boot auto-anchoring of baseline (prevents false takeoff at power-up)
   if (!bootBaselineDone && g_state == ST_PREFLIGHT) {
@@ -785,24 +1054,27 @@ void loop(){
       baselineSet   = true;
       g_cfg.baselineAlt_m = baselineAlt_m;
       g_cfg.baselineSet   = true;
-      nvs_save_settings(g_cfg);
+      settings_persist();
       app_preflight_mark_baseline_ok();                   // arm fallback path
       bootBaselineDone = true;
-      Serial.printf("[QNH] auto-anchored baseline at boot: %.2fm (AGL zeroed)\n", baselineAlt_m);
+      HLOGI("[QNH] auto-anchored baseline at boot: %.2fm (AGL zeroed)\n", baselineAlt_m);
     }
   }
 
+  airfield_autoset(now);
+  baro_select(now);
+
   // Auto-baud recovery: if no valid frames ~3s after the switch, try the other baud
   if (nav_autobaud_arm && !navValid() && (now - nav_switch_ms) > 3000) {
     uint8_t altIdx  = (nav_last_idx == 0) ? 1 : 0;
     uint32_t altBaud = (altIdx == 0) ? 19200u : 38400u;
     halo_apply_nav_baud(altBaud);
     nav_autobaud_arm = false;
-    Serial.printf("[NAV] no frames after switch; auto-trying baud idx=%u (%lu)\n",
+    HLOGI("[NAV] no frames after switch; auto-trying baud idx=%u (%lu)\n",
                   (unsigned)altIdx, (unsigned long)altBaud);
   }
 
-  // Debounced nav-valid chime (track 2)
+  // Debounced nav-valid chime
   bool nv = navValid();
   switch (navEdge) {
     case NAV_INV:
@@ -813,8 +1085,8 @@ void loop(){
         navEdge = NAV_INV;
       } else if (now - navEdge_t >= NAV_VALID_CONFIRM_MS) {
         if (now - lastNavChime_ms >= NAV_CHIME_COOLDOWN_MS) {
-          Serial.println("[AUDIO] navValid (debounced) -> track 2");
-          dfp_play_filename(2);
+          HLOGI("[AUDIO] navValid (debounced) -> chime\n");
+          dfp_play_filename(prompt_track(PROMPT_NAV_OK));
           lastNavChime_ms = now;
         }
         navEdge = NAV_VALID;
@@ -833,111 +1105,241 @@ void loop(){
       break;
   }
 
-  app_fsm_tick(now);
+  { PROF_SCOPE(PROF_FSM); app_fsm_tick(now); }
+  prof_trace(PROF_LAT_FSM, alert.rx_us);
+  power_tick(now);
+  strobeTickSimple();
+  { PROF_SCOPE(PROF_BLE); bleTick(now); }
+  { PROF_SCOPE(PROF_FDR); fdr_tick(now); }
+
+  uint8_t key;
+  while (xQueueReceive(qKeys, &key, 0) == pdTRUE) handle_key(key);
+  settings_handoff();
+
+  { PROF_SCOPE(PROF_STATE); state_publish(); }
+}
+
+static void nav_task(void*){
+  for(;;){ { PROF_SCOPE(PROF_NAV_INGEST); nav_ingest(); } vTaskDelay(pdMS_TO_TICKS(power_nav_poll_ms())); }
+}
+static void control_task(void*){
+  for(;;){
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(power_control_period_ms()));   // woken early by new NMEA
+    control_tick(millis());
+  }
+}
+static void audio_task(void*){
+  for(;;){ { PROF_SCOPE(PROF_AUDIO); dfp_tick(); } vTaskDelay(pdMS_TO_TICKS(AUDIO_PERIOD_MS)); }
+}
+// change-only rendering from the state store
+static void ui_task(void*){
+  static const uint32_t UI_FIELDS = SM_TELE | SM_ALERT | SM_CONFIG | SM_FSM | SM_NAV | SM_UI | SM_FLIGHT;
+  uint32_t seen = 0;
+  tft_text_begin(tft);                 // glyph caches: CPU only, overlaps the splash
+  while (splash != SPLASH_DONE) vTaskDelay(pdMS_TO_TICKS(20));   // loop() owns the TFT until then
+  TickType_t wake = xTaskGetTickCount();
+  for(;;){
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(UI_FRAME_MS));
+    const uint32_t changed = state_read(ui, seen);
+    uiNow = millis();
+    if (changed & SM_UI) markAllUndrawn_local();
+    // Traffic page ages/animates its target on time alone, and the compass tape
+    // turns between fixes; others redraw only on change
+    const bool animating = ui.page == PAGE_TRAFFIC || (ui.page == PAGE_COMPASS && ui.tele.turn_dps != 0.0f);
+    if (!(changed & UI_FIELDS) && !animating) continue;
+    PROF_SCOPE(PROF_UI);
+    drawPage();
+  }
+}
+
+// One-shot: BLE host bring-up takes a few hundred ms; bleTick() idles until it is done
+static void ble_init_task(void*){
+  bleInit();
+  bootBleMs = millis();
+  HLOGI("[BOOT] BLE up at %lu ms\n", (unsigned long)bootBleMs);
+  vTaskDelete(nullptr);
+}
 
-  // change-only rendering
-  if(now-lastUI>=160){
-    switch(g_current_page){
-      case PAGE_TRAFFIC: renderTrafficDynamic(false); break;
-      default: drawPage(); break;
+static void tasks_start(){
+  hlog_begin();
+  power_begin(FLARM_RX_PIN);
+  qBaro = xQueueCreate(BARO_QUEUE, sizeof(BaroSample));
+  qKeys = xQueueCreate(KEY_QUEUE, sizeof(uint8_t));
+  state_publish();
+
+  xTaskCreatePinnedToCore(nav_task,     "nav",     STACK_NAV,     nullptr, PRIO_NAV,     nullptr,      CORE_ALERT);
+  if (tele.bmp_ok)
+    xTaskCreatePinnedToCore(sensor_task, "sensor", STACK_SENSOR,  nullptr, PRIO_SENSOR,  nullptr,      CORE_ALERT);
+  xTaskCreatePinnedToCore(control_task, "control", STACK_CONTROL, nullptr, PRIO_CONTROL, &controlTask, CORE_ALERT);
+  xTaskCreatePinnedToCore(audio_task,   "audio",   STACK_AUDIO,   nullptr, PRIO_AUDIO,   nullptr,      CORE_AUX);
+  xTaskCreatePinnedToCore(ui_task,      "ui",      STACK_UI,      nullptr, PRIO_UI,      nullptr,      CORE_AUX);
+  xTaskCreatePinnedToCore(ble_init_task, "ble_init", STACK_BLE_INIT, nullptr, PRIO_BLE_INIT, nullptr,   CORE_AUX);
+  nav_set_notify(controlTask);
+  Serial.println("[BOOT] tasks started");
+}
+
+// ---------------- Setup / Loop ----------------
+// Resets that should put us back in the air without the splash
+static bool reset_was_unplanned(esp_reset_reason_t r){
+  return r == ESP_RST_BROWNOUT || r == ESP_RST_PANIC || r == ESP_RST_INT_WDT
+      || r == ESP_RST_TASK_WDT || r == ESP_RST_WDT;
+}
+
+// Boot order: the alert path (config, sensors, nav, FSM, tasks) comes up first;
+// BLE initializes in the background and the DFPlayer runs its own init sequence
+// in the audio task. The display (ST7735 init alone holds ~0.7 s of delays) and
+// the splash follow while everything else is already running.
+void setup(){
+  Serial.setRxBufferSize(DP_RX_BUFFER);     // must precede begin(); the data port needs the headroom
+  Serial.begin(115200);                     // no wait for a USB host
+  const esp_reset_reason_t resetReason = esp_reset_reason();
+
+  // Telemetry defaults
+  tele_init_defaults();
+
+  // I2C / BMP280
+  Wire.begin(I2C_SDA, I2C_SCL, 100000);
+  bool found=false; uint8_t addr=0x76;
+  for(uint8_t a:{(uint8_t)0x76,(uint8_t)0x77}){ Wire.beginTransmission(a); if(Wire.endTransmission()==0){ addr=a; found=true; break; } }
+  if(found && baro_begin(addr)){              // ground profile until the control task picks one
+    tele.bmp_ok=true;
+  }
+
+  // Strobe GPIO
+  pinMode(STROBE_PIN, OUTPUT); strobeApply(false); strobeSet(120,2000); strobeEnable(false);
+
+  // NVS
+  nvs_init();
+  nvs_load_settings(g_cfg);
+  logbook_begin();
+  encounters_begin();
+  fdr_begin();
+  assets_begin();
+  prompts_load();                          // before any prompt plays
+  airfields_begin();
+
+  // Apply to runtime
+  qnh_hPa         = g_cfg.qnh_hPa;
+  airfieldElev_ft = g_cfg.airfieldElev_ft;
+  df_volume       = g_cfg.volume0_30;
+  baselineSet     = g_cfg.baselineSet;
+  baselineAlt_m   = g_cfg.baselineAlt_m;
+
+  // Choose nav baud from data source (0=FLARM, 1=SoftRF)
+  g_nav_baud = (g_cfg.data_source != 0) ? 38400u : 19200u;
+
+  // Bring the alert path up
+  dfp_begin(DFSerial, DF_TX_PIN, DF_BUSY_PIN, DF_BAUD, df_volume);
+  nav_begin(FLARM, FLARM_RX_PIN, g_nav_baud);
+  const bool resumed = reset_was_unplanned(resetReason) && app_fsm_resume_flight();
+  if (!resumed) app_fsm_init();
+
+  // *** NEW *** schedule boot auto-anchor if nav is invalid initially (ground boots only)
+  bootBaselineDone     = resumed;
+  bootBaselineDeadline = millis() + 10000; // ~10 s after init
+
+  tasks_start();
+  if (!resumed) dfp_play_filename(prompt_track(PROMPT_BOOT));      // boot chime; plays once the DFPlayer init sequence ends
+  Serial.printf("[BOOT] alert path up at %lu ms (reset reason %d%s)\n",
+                (unsigned long)millis(), (int)resetReason, resumed ? ", flight resumed" : "");
+
+  // Display / backlight
+  ledcSetup(BL_CH, BL_FREQ, BL_BITS); ledcAttachPin(TFT_BL, BL_CH); setBrightness(255);
+  SPI.begin(TFT_SCLK, TFT_MISO, TFT_MOSI, TFT_CS);
+  tft.initR(INITR_GREENTAB); tft.setRotation(1); tft.setSPISpeed(12000000);
+  tft.fillScreen(COL_BG); tft.setTextColor(COL_FG); tft.setTextSize(1);
+
+  // Splash (skipped when resuming a flight; the ui task starts drawing at SPLASH_DONE)
+  splash_t = millis();
+  splash = resumed ? SPLASH_DONE : SPLASH_START;
+}
+
+// Housekeeping (Arduino loop task, core 1, lowest priority): splash, then console
+void loop(){
+  // SPLASH / VERSION
+  if(splash!=SPLASH_DONE){
+    splash_tick();
+    if(splash==SPLASH_DONE){
+      bootShownSince_ms = millis();
+      HLOGI("[BOOT] splash done at %lu ms\n", (unsigned long)bootShownSince_ms);
     }
-    lastUI=now;
+    return;
   }
 
-  dfp_tick();
-  strobeTickSimple();
-  bleTick(now);
+  // ---- USB data port (HIL): the link carries frames instead of keys ----
+  if (dataport_active()) {
+    dataport_poll(millis());
+    settings_service();
+    app_fsm_service();
+    encounters_service();
+    vTaskDelay(1);
+    return;
+  }
 
   // ---- Console test keys (drain; C = hard reset to boot) ----
-  while (Serial.available() > 0) {
+  while (Serial.available() > 0 && !dataport_active()) {
     int raw = Serial.read();
     if (raw < 0) break;
     if (raw == '\r' || raw == '\n') continue;
 
-    char printable = (raw >= 32 && raw < 127) ? (char)raw : '.';
-    Serial.printf("[KEYDBG] rx=0x%02X '%c'\n", (unsigned)raw, printable);
+    HLOGD("[KEYDBG] rx=0x%02X '%c'\n", (unsigned)raw, (raw >= 32 && raw < 127) ? (char)raw : '.');
 
     int ch = toupper((unsigned char)raw);
     switch (ch) {
-      case 'J':
-        Serial.println("[KEY] J -> play 3");
-        dfp_stop_and_flush();
-        dfp_play_filename(3);
+      // Storage dumps are slow; keep them off the control task
+      case 'B':
+        Serial.println("[KEY] B -> logbook");
+        logbook_dump(Serial);
         break;
 
-      case 'T': {
-        Serial.println("[KEY] T -> DEMO: force FLYING");
-        tele.sog_kts   = 25.0f;
-        tele.track_deg = 0.0f;
-        app_demo_force_flying();
-      } break;
+      case 'F':
+        Serial.println("[KEY] F -> flight data export");
+        fdr_export(Serial);
+        break;
 
-      case 'L': {
-        Serial.println("[KEY] L -> DEMO: landing");
-        if (!baselineSet && !isnan(tele.alt_m)) { baselineAlt_m = tele.alt_m; baselineSet=true; }
-        tele.sog_kts = 0.0f;
-        app_demo_force_landing();
-      } break;
+      case 'E':
+        Serial.println("[KEY] E -> encounters");
+        encounters_dump(Serial);
+        break;
 
-      case 'R': {
-        if (!isnan(tele.alt_m)) {
-          baselineAlt_m = tele.alt_m; baselineSet = true;
-          g_cfg.baselineSet = baselineSet;
-          g_cfg.baselineAlt_m = baselineAlt_m;
-          nvs_save_settings(g_cfg);
-          Serial.printf("[KEY] R -> baselineAlt_m=%.1f m (saved)\n", baselineAlt_m);
-        } else Serial.println("[KEY] R -> cannot set baseline (alt_m is NaN)");
-      } break;
+      case 'A':
+        Serial.println("[KEY] A -> assets");
+        assets_dump(Serial);
+        break;
 
-      case '1':
-      case '2':
-      case '3': {
-        int lvl = ch - '0';
-        Serial.printf("[KEY] %c -> DEMO alert L%d\n", ch, lvl);
-
-        alert.active = true;
-        alert.since  = millis();
-        alert.alarm  = lvl;
-
-        alert.relN_m = 500;
-        alert.relE_m = 866;
-        alert.relV_m = (lvl==1 ? 0 : (lvl==2 ? +70 : -70));
-        alert.dist_m = sqrtf(alert.relN_m*alert.relN_m + alert.relE_m*alert.relE_m);
-        float brgN   = atan2f(alert.relE_m, alert.relN_m) * 180.0f / 3.1415926f;
-        if (brgN < 0) brgN += 360.0f;
-        alert.bearing_deg = brgN;
-
-        ui_set_page(PAGE_TRAFFIC);
-        renderTrafficDynamic(true);
-
-        uint16_t vtrk;
-        float dAlt_ft = alert.relV_m * 3.28084f;
-        if (dAlt_ft >  200.0f) vtrk = 11; else if (dAlt_ft < -200.0f) vtrk = 12; else vtrk = 10;
-        dfp_stop_and_flush();
-        dfp_play_filename(vtrk);
-        delay(140);
-        dfp_play_filename(22);
+      case 'N': {
+        Serial.println("[KEY] N -> nearest airfield");
+        static HaloState snap;             // tele belongs to the control task
+        static uint32_t  snapSeen = 0;
+        state_read(snap, snapSeen);
+        airfields_report(Serial, snap.tele);
       } break;
 
-      case 'C': {
-        Serial.println("[KEY] C -> HARD RESET to BOOT");
-        bleCancelTests();
-        dfp_stop_and_flush();
-        alert = {};
-        strobeEnable(false);
-        app_fsm_init();
-        ui_markAllUndrawn();
-        ui_set_page(PAGE_BOOT);
-        navWasValid = false;   // so we’ll chime again when nav becomes valid next time
-
-        // *** NEW *** also reset auto-anchor so we can zero AGL again if needed
-        bootBaselineDone     = false;
-        bootBaselineDeadline = millis() + 10000;
-      } break;
+      case 'G':
+        Serial.println("[KEY] G -> geometry kernel benchmark");
+        geom_bench(Serial);
+        break;
+
+      case 'D':
+        Serial.println("[KEY] D -> USB data port");
+        dataport_enter();
+        break;
 
-      default:
-        Serial.printf("[KEY] unhandled: 0x%02X\n", (unsigned)raw);
+      case 'P':
+        Serial.println("[KEY] P -> profiler");
+        Serial.printf("[BOOT] control %lu ms, ready %lu ms, BLE %lu ms\n",
+                      (unsigned long)bootControlMs, (unsigned long)bootReadyMs, (unsigned long)bootBleMs);
+        prof_dump(Serial);
         break;
+
+      default: {
+        uint8_t k = (uint8_t)ch;
+        if (xQueueSend(qKeys, &k, 0) != pdTRUE) HLOGW("[KEY] queue full\n");
+      } break;
     }
   }
+  settings_service();                      // queued settings -> NVS
+  app_fsm_service();                       // closed flights -> NVS totals + logbook
+  encounters_service();                    // queued encounter records -> flash
+  vTaskDelay(pdMS_TO_TICKS(20));
 }
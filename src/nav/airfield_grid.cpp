@@ -0,0 +1,61 @@
+#include "airfield_grid.h"
+#include "../util/fixed_trig.h"
+
+static const float M_PER_E7 = 0.0111319491f;     // metres per 1e-7 degree of latitude
+
+bool airfield_grid_open(AirfieldGrid& g, const void* blob, uint32_t size){
+  g = AirfieldGrid{};
+  const AssetAirfields* h = (const AssetAirfields*)blob;
+  if (!h || size < sizeof(AssetAirfields)) return false;
+  const uint64_t need = sizeof(AssetAirfields) + (uint64_t)(h->ncells + 1) * sizeof(AssetAirfieldCell)
+                      + (uint64_t)h->count * sizeof(AssetAirfield);
+  const AssetAirfieldCell* cs = (const AssetAirfieldCell*)(h + 1);
+  if (!h->rows || !h->cols || !h->cell_e7 || size < need || cs[h->ncells].start != h->count) return false;
+  g.db = h; g.cells = cs; g.recs = (const AssetAirfield*)(cs + h->ncells + 1);
+  return true;
+}
+
+// Grid row/column of a coordinate, clamped into [0, n)
+static int cell_of(const AssetAirfields* db, int32_t v_e7, int32_t origin_e7, int n){
+  const int64_t k = ((int64_t)v_e7 - origin_e7) / (int64_t)db->cell_e7 - ((int64_t)v_e7 < origin_e7);   // floor
+  return k < 0 ? 0 : (k >= n ? n - 1 : (int)k);
+}
+
+const AssetAirfield* airfield_grid_nearest(const AirfieldGrid& g, int32_t lat_e7, int32_t lon_e7,
+                                           float max_m, float* dist_m){
+  const AssetAirfields* db = g.db;
+  if (!db) return nullptr;
+  // Equirectangular metres; the longitude scale is cos(lat) from the Q15 table
+  const float kLon = fmaxf(0.02f, icos(bam_from_deg(lat_e7 * 1e-7f)) / (float)Q15_ONE);
+  const int32_t dLat = (int32_t)(max_m / M_PER_E7) + 1;
+  const int32_t dLon = (int32_t)fminf(1.8e9f, max_m / (M_PER_E7 * kLon)) + 1;
+
+  const int64_t latMax = (int64_t)db->lat0_e7 + (int64_t)db->rows * db->cell_e7;
+  const int64_t lonMax = (int64_t)db->lon0_e7 + (int64_t)db->cols * db->cell_e7;
+  if ((int64_t)lat_e7 + dLat < db->lat0_e7 || (int64_t)lat_e7 - dLat >= latMax) return nullptr;
+  if ((int64_t)lon_e7 + dLon < db->lon0_e7 || (int64_t)lon_e7 - dLon >= lonMax) return nullptr;
+  const int64_t lonLo = (int64_t)lon_e7 - dLon, lonHi = (int64_t)lon_e7 + dLon;
+  const int r0 = cell_of(db, lat_e7 - dLat, db->lat0_e7, db->rows), r1 = cell_of(db, lat_e7 + dLat, db->lat0_e7, db->rows);
+  const int c0 = cell_of(db, (int32_t)(lonLo < INT32_MIN ? INT32_MIN : lonLo), db->lon0_e7, db->cols);
+  const int c1 = cell_of(db, (int32_t)(lonHi > INT32_MAX ? INT32_MAX : lonHi), db->lon0_e7, db->cols);
+
+  const AssetAirfield* best = nullptr;
+  float bestD2 = max_m * max_m;
+  for (int r = r0; r <= r1; ++r) {
+    // First listed cell at or after (r, c0); cells up to (r, c1) follow it, and
+    // so do their records
+    const uint32_t id0 = (uint32_t)r * db->cols + c0, id1 = (uint32_t)r * db->cols + c1;
+    uint32_t lo = 0, hi = db->ncells;
+    while (lo < hi) { const uint32_t mid = (lo + hi) / 2; if (g.cells[mid].id < id0) lo = mid + 1; else hi = mid; }
+    uint32_t k = lo;
+    while (k < db->ncells && g.cells[k].id <= id1) ++k;
+    for (uint32_t i = g.cells[lo].start; i < g.cells[k].start; ++i) {
+      const float n = (float)((int64_t)g.recs[i].lat_e7 - lat_e7) * M_PER_E7;
+      const float e = (float)((int64_t)g.recs[i].lon_e7 - lon_e7) * (M_PER_E7 * kLon);
+      const float d2 = n * n + e * e;
+      if (d2 <= bestD2) { bestD2 = d2; best = &g.recs[i]; }
+    }
+  }
+  if (best && dist_m) *dist_m = sqrtf(bestD2);
+  return best;
+}
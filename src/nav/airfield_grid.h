@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include "../storage/asset_format.h"
+
+// Nearest-field lookup over an airfield database image (AssetAirfields, built
+// by tools/mkairfields.py). Pure: no Arduino or flash access, so the same code
+// runs on the host tests; nav/airfields.h binds it to the mapped asset.
+struct AirfieldGrid {
+  const AssetAirfields*    db    = nullptr;
+  const AssetAirfieldCell* cells = nullptr;   // ncells + sentinel, sorted by id
+  const AssetAirfield*     recs  = nullptr;
+};
+
+// Validate `size` bytes at `blob` and point `g` into it; false if malformed
+bool airfield_grid_open(AirfieldGrid& g, const void* blob, uint32_t size);
+
+// Nearest field within max_m of (lat, lon) (degrees * 1e7); nullptr if none.
+// Distances are equirectangular, with cos(lat) taken at the query point.
+const AssetAirfield* airfield_grid_nearest(const AirfieldGrid& g, int32_t lat_e7, int32_t lon_e7,
+                                           float max_m, float* dist_m = nullptr);
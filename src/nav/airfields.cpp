@@ -0,0 +1,36 @@
+#include "airfields.h"
+#include "airfield_grid.h"
+
+static AirfieldGrid grid;
+
+bool airfields_begin(){
+  uint32_t size = 0;
+  const void* blob = assets_find("airfields", ASSET_AIRFIELDS, &size);
+  if (!blob) return false;
+  if (!airfield_grid_open(grid, blob, size)) {
+    Serial.println("[AIRFIELD] database malformed, ignored");
+    return false;
+  }
+  const AssetAirfields* h = grid.db;
+  Serial.printf("[AIRFIELD] %lu fields in %lu cells (%ux%u grid)\n", (unsigned long)h->count,
+                (unsigned long)h->ncells, (unsigned)h->rows, (unsigned)h->cols);
+  return true;
+}
+
+uint32_t airfields_count(){ return grid.db ? grid.db->count : 0; }
+
+const AssetAirfield* airfield_nearest(int32_t lat_e7, int32_t lon_e7, float max_m, float* dist_m){
+  return airfield_grid_nearest(grid, lat_e7, lon_e7, max_m, dist_m);
+}
+
+void airfields_report(Print& out, const Telemetry& t){
+  if (!grid.db)  { out.printf("[AIRFIELD] no database\n"); return; }
+  if (!t.pos_ms) { out.printf("[AIRFIELD] %lu fields; no position yet\n", (unsigned long)grid.db->count); return; }
+  float d = 0;
+  const uint32_t t0 = micros();
+  const AssetAirfield* f = airfield_nearest(t.lat_e7, t.lon_e7, 50000.0f, &d);
+  const uint32_t us = micros() - t0;
+  out.printf("[AIRFIELD] fix %.5f %.5f (age %lu ms)\n", t.lat_e7 * 1e-7, t.lon_e7 * 1e-7, (unsigned long)(millis() - t.pos_ms));
+  if (f) out.printf("[AIRFIELD] nearest %.6s, %d ft, %.0f m away (%lu us)\n", f->ident, (int)f->elev_ft, d, (unsigned long)us);
+  else   out.printf("[AIRFIELD] none within 50 km (%lu us)\n", (unsigned long)us);
+}
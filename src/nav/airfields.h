@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+#include "../storage/assets.h"
+#include "../app/telemetry.h"
+
+// Airfield database: the "airfields" asset (tools/mkairfields.py), read in
+// place from the mapped asset partition. The lookup itself is
+// nav/airfield_grid.h.
+//
+// Records are bucketed into a lat/lon grid that lists only non-empty cells, so
+// the index grows with the data, not its extent. A nearest-field query binary
+// searches the grid rows that intersect the search radius and scans a handful
+// of records - a few microseconds. Used on the ground to take the field
+// elevation (and from it QNH and the AGL baseline) without pilot input.
+
+bool airfields_begin();                 // after assets_begin(); false = no database
+uint32_t airfields_count();
+
+// Nearest field within max_m of (lat, lon) (degrees * 1e7); nullptr if none.
+const AssetAirfield* airfield_nearest(int32_t lat_e7, int32_t lon_e7, float max_m, float* dist_m = nullptr);
+
+// Bench: nearest field to the current fix, with lookup time
+void airfields_report(Print& out, const Telemetry& t);
@@ -1,31 +1,85 @@
 #include "flarm.h"
+#include "traffic.h"
+#include "heading.h"
+#include "gdl90.h"
+#include "nmea_coord.h"
 #include "../app/telemetry.h"
 #include "../app/constants.h"
+#include "../app/rtos_cfg.h"
+#include "../util/prof.h"
+#include "../util/hlog.h"
+#include "../util/fixed_trig.h"
+#include "../ble/ble_nmea.h"
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
 static HardwareSerial* fl_port = nullptr;
 static int   fl_rx_pin = -1;
 static uint32_t fl_baud = 0;
 
+// Ingest (nav task) frames lines and hands them to the parser (control task).
+// The UART is only touched by the nav task; nav_begin() asks it to reopen.
+// nav_feed_*() put lines/GDL90 messages from other transports on the same queue.
+static const size_t   LINE_MAX = 128;
+enum : uint8_t { NAV_NMEA = 0, NAV_GDL90 = 1 };
+struct NavLine {
+  uint32_t rx_us;         // first byte read (latency trace)
+  uint8_t  kind;          // NAV_NMEA: s is a NUL-terminated line; NAV_GDL90: len bytes
+  uint8_t  len;
+  char     s[LINE_MAX];
+};
+static QueueHandle_t  lineQ     = nullptr;
+static TaskHandle_t   notifyTo  = nullptr;
+static volatile bool  reopenReq = false;
+static volatile uint32_t linesDropped = 0;
+static volatile uint32_t lastRxMs = 0;
+
 static bool rmc_valid = false;   // RMC 'A' = valid
 static uint32_t rmc_ms = 0;
 static int  gga_sats = 0;
 static uint32_t gga_ms = 0;
+static uint32_t own_ms = 0;              // last GDL90 ownship report with a position
+static int32_t  own_alt_ft = INT32_MIN;  // its pressure altitude
 
 bool navValid(){
   uint32_t now = millis();
+  if (own_ms && now - own_ms < 2500) return true;
   return rmc_valid && (gga_sats >= 4)
       && (now - rmc_ms  < 2500)
       && (now - gga_ms  < 3500);
 }
 
+// Days since 1970-01-01 for a civil date (proleptic Gregorian)
+static int32_t days_from_civil(int y, int m, int d){
+  y -= (m <= 2);
+  const int32_t era = (y >= 0 ? y : y - 399) / 400;
+  const uint32_t yoe = (uint32_t)(y - era * 400);
+  const uint32_t doy = (153u * (uint32_t)(m + (m > 2 ? -3 : 9)) + 2u) / 5u + (uint32_t)d - 1u;
+  const uint32_t doe = yoe * 365u + yoe / 4u - yoe / 100u + doy;
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+uint32_t nav_utc_now(){
+  if (!tele.utc_epoch) return 0;
+  return tele.utc_epoch + (millis() - tele.last_nmea_ms) / 1000u;
+}
+
+static void set_position(const char* lat, char ns, const char* lon, char ew){
+  int32_t la, lo;
+  if (!nmea_coord_e7(lat, ns, la) || !nmea_coord_e7(lon, ew, lo)) return;
+  tele.lat_e7 = la; tele.lon_e7 = lo; tele.pos_ms = millis();
+}
+
 static void handleRMC(const char* s){
   // Fields (0-based after talker+type):
-  // 1: hhmmss.sss  2: Status A/V  7: SOG(knots)  8: COG(deg)
+  // 1: hhmmss.sss  2: Status A/V  3,4: lat N/S  5,6: lon E/W  7: SOG(knots)  8: COG(deg)  9: ddmmyy
   int field=0; const char* p=s; char tok[32]; int ti=0;
   float sog=-1, cog=-1; bool valid=false;
+  char lat[16] = "", lon[16] = "", ns = 0, ew = 0;
 
   // Temporary for time
-  int utc_hh = -1, utc_mm = -1;
+  int utc_hh = -1, utc_mm = -1, utc_ss = -1;
+  int dd = 0, mo = 0, yy = -1;
   bool saw_time_field = false;
 
   while(*p){
@@ -37,14 +91,24 @@ static void handleRMC(const char* s){
         if (tok[0] && tok[1] && tok[2] && tok[3] && tok[4] && tok[5]) {
           int hh = (tok[0]-'0')*10 + (tok[1]-'0');
           int mm = (tok[2]-'0')*10 + (tok[3]-'0');
-          // seconds not needed now
+          int ss = (tok[4]-'0')*10 + (tok[5]-'0');
           if (hh>=0 && hh<24 && mm>=0 && mm<60) { utc_hh = hh; utc_mm = mm; }
+          if (ss>=0 && ss<61) utc_ss = ss;
         }
         saw_time_field = true;
       }
       if(field==2) valid = (tok[0]=='A');  // status
+      if(field==3) strlcpy(lat, tok, sizeof(lat));
+      if(field==4) ns    = tok[0];
+      if(field==5) strlcpy(lon, tok, sizeof(lon));
+      if(field==6) ew    = tok[0];
       if(field==7) sog   = atof(tok);      // speed(kn)
       if(field==8) cog   = atof(tok);      // course
+      if(field==9 && tok[0] && tok[1] && tok[2] && tok[3] && tok[4] && tok[5]){ // date ddmmyy
+        dd = (tok[0]-'0')*10 + (tok[1]-'0');
+        mo = (tok[2]-'0')*10 + (tok[3]-'0');
+        yy = (tok[4]-'0')*10 + (tok[5]-'0');
+      }
 
       field++; ti=0; if(*p=='*') break;
     } else if(ti< (int)sizeof(tok)-1){
@@ -56,7 +120,8 @@ static void handleRMC(const char* s){
   rmc_valid = valid; rmc_ms = millis();
   if(valid){
     if(sog>=0) tele.sog_kts   = sog;
-    if(cog>=0) tele.track_deg = fmodf(cog,360.0f);
+    if(cog>=0) heading_on_fix(fmodf(cog,360.0f), sog, millis());
+    set_position(lat, ns, lon, ew);
 
     // Update UTC only if we actually saw the time field in this sentence
     if (saw_time_field) {
@@ -64,75 +129,180 @@ static void handleRMC(const char* s){
       tele.utc_min  = utc_mm;   // may be -1 if malformed
     }
 
+    // Full timestamp only when both time and a plausible date are present
+    if (utc_hh >= 0 && utc_ss >= 0 && yy >= 0 && mo >= 1 && mo <= 12 && dd >= 1 && dd <= 31) {
+      int32_t days = days_from_civil(2000 + yy, mo, dd);
+      tele.utc_epoch = (uint32_t)days * 86400u + (uint32_t)(utc_hh * 3600 + utc_mm * 60 + utc_ss);
+    }
+
     tele.last_nmea_ms = millis();
   }
 }
 
+// 2,3: lat N/S  4,5: lon E/W  6: fix quality (0 = none)  7: satellites
 static void handleGGA(const char* s){
-  int field=0; const char* p=s; char tok[24]; int ti=0; int sats=0;
+  int field=0; const char* p=s; char tok[24]; int ti=0; int sats=0, quality=0;
+  char lat[16] = "", lon[16] = "", ns = 0, ew = 0;
   while(*p){
     if(*p==','||*p=='*'){ tok[ti]=0;
+      if(field==2) strlcpy(lat, tok, sizeof(lat));
+      if(field==3) ns      = tok[0];
+      if(field==4) strlcpy(lon, tok, sizeof(lon));
+      if(field==5) ew      = tok[0];
+      if(field==6) quality = atoi(tok);
       if(field==7) sats = atoi(tok);
       field++; ti=0; if(*p=='*') break;
     } else if(ti< (int)sizeof(tok)-1) tok[ti++]=*p;
     ++p;
   }
   gga_sats = sats; gga_ms = millis();
+  if (quality > 0) set_position(lat, ns, lon, ew);
 }
 
-static void handlePFLAA(const char* s){
+// $PFLAA,<AlarmLevel>,<RelN>,<RelE>,<RelV>,<IDType>,<ID>,<Track>,<TurnRate>,<GS>,<Climb>,<AcftType>
+static void handlePFLAA(const char* s, uint32_t rx_us){
   int field=0; const char* p=s; char tok[24]; int ti=0; int alarm=0; float rn=0,re=0,rv=0;
+  uint32_t idType=0, id=0; bool idOk=false;
   while(*p){
     if(*p==','||*p=='*'){ tok[ti]=0;
-      if(field==0) alarm = atoi(tok);
-      if(field==1) rn    = atof(tok);
-      if(field==2) re    = atof(tok);
-      if(field==3) rv    = atof(tok);
+      if(field==1) alarm  = atoi(tok);
+      if(field==2) rn     = atof(tok);
+      if(field==3) re     = atof(tok);
+      if(field==4) rv     = atof(tok);
+      if(field==5) idType = (uint32_t)atoi(tok);
+      if(field==6) { char* end; id = (uint32_t)strtoul(tok, &end, 16); idOk = ti > 0 && *end == 0; }
       field++; ti=0; if(*p=='*') break;
     } else if(ti< (int)sizeof(tok)-1) tok[ti++]=*p;
     ++p;
   }
-  float dist = sqrtf(rn*rn + re*re);
-  float brgN = atan2f(re, rn) * 180.0f / 3.1415926f; if(brgN<0) brgN += 360.0f;
+  traffic_update(idOk ? ((idType & 0xFF) << 24) | (id & 0xFFFFFF) : TRAFFIC_NO_ID,
+                 (uint8_t)constrain(alarm, 0, 3), rn, re, rv, rx_us, millis());
+  prof_trace(PROF_LAT_PARSE, rx_us);
+}
 
-  alert.active = true; alert.since = millis();
-  alert.relN_m = rn; alert.relE_m = re; alert.relV_m = rv;
-  alert.dist_m = dist; alert.bearing_deg = brgN; alert.alarm = alarm;
+// GDL90 Heartbeat / Ownship / Traffic. Traffic is made relative to the own
+// position (from either source); vertical uses the ownship pressure altitude,
+// else the baro altitude.
+static void handleGDL90(const uint8_t* m, size_t n, uint32_t rx_us){
+  const uint32_t now = millis();
+  uint32_t utc_s; bool utc_ok, gps_ok;
+  if (gdl90_heartbeat(m, n, utc_s, utc_ok, gps_ok)) {
+    if (utc_ok && utc_s < 86400) { tele.utc_hour = (int)(utc_s / 3600); tele.utc_min = (int)(utc_s / 60 % 60); }
+    return;
+  }
+  Gdl90Report r;
+  if (!gdl90_report(m, n, r)) return;
+  if (m[0] == GDL90_OWNSHIP) {
+    if (!r.nic || (!r.lat_e7 && !r.lon_e7)) return;
+    tele.lat_e7 = r.lat_e7; tele.lon_e7 = r.lon_e7; tele.pos_ms = now;
+    if (!isnan(r.gs_kts))    tele.sog_kts = r.gs_kts;
+    if (!isnan(r.track_deg)) heading_on_fix(r.track_deg, isnan(r.gs_kts) ? 0.0f : r.gs_kts, now);
+    own_alt_ft = r.alt_ft; own_ms = now;
+    tele.last_nmea_ms = now;
+    return;
+  }
+  if (!tele.pos_ms || !r.nic) return;
+  static const float M_PER_E7 = 0.0111319491f;
+  const float kLon = icos(bam_from_deg(tele.lat_e7 * 1e-7f)) / (float)Q15_ONE;
+  const float rn = (float)((int64_t)r.lat_e7 - tele.lat_e7) * M_PER_E7;
+  int64_t dLon = (int64_t)r.lon_e7 - tele.lon_e7;
+  if (dLon > 1800000000LL) dLon -= 3600000000LL; else if (dLon < -1800000000LL) dLon += 3600000000LL;
+  const float re = (float)dLon * (M_PER_E7 * kLon);
+  float rv = 0;
+  if (r.alt_ft != INT32_MIN) {
+    if (own_alt_ft != INT32_MIN)  rv = (r.alt_ft - own_alt_ft) * 0.3048f;
+    else if (!isnan(tele.alt_m))  rv = r.alt_ft * 0.3048f - tele.alt_m;
+  }
+  const uint32_t idType = (r.addr_type == 0 || r.addr_type == 2) ? 1 : 0;   // ICAO, else other
+  traffic_update((idType << 24) | r.addr, r.alert ? 1 : 0, rn, re, rv, rx_us, now);
+  prof_trace(PROF_LAT_PARSE, rx_us);
 }
 
-static void parse_line(const char* line){
+static void parse_line(const char* line, uint32_t rx_us){
   if(!line || !line[0]) return;
   if(!strncmp(line,"$GPRMC",6) || !strncmp(line,"$GNRMC",6)) handleRMC(line);
   else if(!strncmp(line,"$GPGGA",6)|| !strncmp(line,"$GNGGA",6)) handleGGA(line);
-  else if(!strncmp(line,"$PFLAA",6)) handlePFLAA(line);
+  else if(!strncmp(line,"$PFLAA",6)) handlePFLAA(line, rx_us);
 }
 
 void nav_inject_nmea(const char* s){
-  parse_line(s);
+  parse_line(s, prof_trace_now());
 }
 
 void nav_begin(HardwareSerial& port, int rxPin, uint32_t baud){
+  if (!lineQ) lineQ = xQueueCreate(NAV_LINE_QUEUE, sizeof(NavLine));
   fl_port  = &port; fl_rx_pin = rxPin; fl_baud = baud;
-  fl_port->begin(fl_baud, SERIAL_8N1, fl_rx_pin, -1);
-  rmc_valid=false; rmc_ms=0; gga_sats=0; gga_ms=0;
+  reopenReq = true;                 // nav task re-opens the port and drops stale bytes
+  rmc_valid=false; rmc_ms=0; gga_sats=0; gga_ms=0; own_ms=0; own_alt_ft=INT32_MIN;
   // initialize UTC to unknown
-  tele.utc_hour = -1; tele.utc_min = -1;
+  tele.utc_hour = -1; tele.utc_min = -1; tele.utc_epoch = 0;
 }
 
-void nav_tick(){
-  if(!fl_port) return;
-  static char buf[200]; static uint8_t len=0;
+void nav_set_notify(TaskHandle_t task){ notifyTo = task; }
+
+static bool feed(uint8_t kind, const void* p, size_t n, TickType_t wait){
+  if (!lineQ || n == 0 || n >= LINE_MAX) return false;
+  NavLine line;
+  line.rx_us = prof_trace_now();
+  line.kind  = kind;
+  line.len   = (uint8_t)n;
+  memcpy(line.s, p, n); line.s[n] = 0;
+  if (xQueueSend(lineQ, &line, wait) != pdTRUE) { linesDropped++; return false; }
+  if (notifyTo) xTaskNotifyGive(notifyTo);
+  return true;
+}
+
+bool nav_feed_line(const char* s, size_t len, TickType_t wait){ return feed(NAV_NMEA, s, len, wait); }
+bool nav_feed_gdl90(const uint8_t* m, size_t len, TickType_t wait){ return feed(NAV_GDL90, m, len, wait); }
+
+uint32_t nav_last_rx_ms(){ return lastRxMs; }
+
+void nav_ingest(){
+  if(!fl_port || !lineQ) return;
+  static NavLine line; static uint8_t len=0;
+
+  if(reopenReq){
+    reopenReq = false;
+    fl_port->begin(fl_baud, SERIAL_8N1, fl_rx_pin, -1);
+    while(fl_port->available()) (void)fl_port->read();
+    len = 0;
+  }
+
+  bool posted = false;
+  if(fl_port->available()) lastRxMs = millis();
   while(fl_port->available()){
     char c = (char)fl_port->read();
     if(c=='\r') continue;
     if(c=='\n'){
-      buf[len]=0;
-      if(len) parse_line(buf);
+      line.s[len]=0;
+      line.kind=NAV_NMEA; line.len=len;
+      if(len){
+        if(xQueueSend(lineQ, &line, 0) == pdTRUE) posted = true;
+        else linesDropped++;
+      }
       len=0;
-    } else if(len < sizeof(buf)-1){
-      buf[len++] = c;
+    } else if(len < LINE_MAX-1){
+      if(len==0) line.rx_us = prof_trace_now();
+      line.s[len++] = c;
     } else {
       len=0; // overflow guard
     }
   }
+  if(posted && notifyTo) xTaskNotifyGive(notifyTo);
+}
+
+void nav_tick(){
+  if(!lineQ) return;
+  NavLine line;
+  while(xQueueReceive(lineQ, &line, 0) == pdTRUE){
+    if(line.kind == NAV_GDL90){ handleGDL90((const uint8_t*)line.s, line.len, line.rx_us); continue; }
+    parse_line(line.s, line.rx_us);
+    ble_nmea_push(line.s, line.len);   // after the parse: the alert never waits on the bridge
+  }
+  traffic_evaluate(millis());
+
+  if(linesDropped){
+    HLOGW("[NAV] %lu line(s) dropped (parser behind)\n", (unsigned long)linesDropped);
+    linesDropped = 0;
+  }
 }
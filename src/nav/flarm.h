@@ -1,9 +1,28 @@
 #pragma once
 #include <Arduino.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// (Re)open the nav UART; the nav task performs the open on its next poll.
 void nav_begin(HardwareSerial& port, int rxPin, uint32_t baud);
+// Nav task: read UART bytes and queue whole NMEA lines (no parsing).
+void nav_ingest();
+// Other transports (USB data port): queue a whole NMEA line (no CR/LF) or an
+// unescaped GDL90 message (id + payload, no CRC) for the same parser. Waits up
+// to `wait` ticks while the queue is full; false = dropped (counted).
+bool nav_feed_line(const char* s, size_t len, TickType_t wait);
+bool nav_feed_gdl90(const uint8_t* msg, size_t len, TickType_t wait);
+// Task to wake when a line is queued (the parser's task).
+void nav_set_notify(TaskHandle_t task);
+// Control task: parse queued lines into tele/alert.
 void nav_tick();
 bool navValid();
+// millis() of the last byte read from the nav UART (0 = none yet)
+uint32_t nav_last_rx_ms();
+
+// Current UTC as unix seconds (last RMC time/date advanced by millis), 0 if unknown
+uint32_t nav_utc_now();
 
 // For test harness: inject a full NMEA sentence (e.g. "$GNRMC,...\n")
 void nav_inject_nmea(const char* line);
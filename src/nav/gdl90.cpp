@@ -0,0 +1,79 @@
+#include "gdl90.h"
+
+// Table-driven CRC as given in the ICD (MSB first, no reflection)
+static uint16_t crc_table[256];
+static bool     crc_ready = false;
+
+static void crc_init(){
+  for (int i=0; i<256; ++i) {
+    uint16_t c = (uint16_t)(i << 8);
+    for (int b=0; b<8; ++b) c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x1021) : (uint16_t)(c << 1);
+    crc_table[i] = c;
+  }
+  crc_ready = true;
+}
+
+uint16_t gdl90_crc(const uint8_t* p, size_t n){
+  if (!crc_ready) crc_init();
+  uint16_t crc = 0;
+  while (n--) crc = (uint16_t)(crc_table[crc >> 8] ^ (crc << 8) ^ *p++);
+  return crc;
+}
+
+static inline bool put(uint8_t* out, size_t cap, size_t& o, uint8_t b){
+  if (b == GDL90_FLAG || b == GDL90_ESC) {
+    if (o + 2 > cap) return false;
+    out[o++] = GDL90_ESC; out[o++] = b ^ 0x20;
+  } else {
+    if (o + 1 > cap) return false;
+    out[o++] = b;
+  }
+  return true;
+}
+
+size_t gdl90_frame(uint8_t* out, size_t cap, const uint8_t* msg, size_t n){
+  const uint16_t crc = gdl90_crc(msg, n);
+  size_t o = 0;
+  if (cap < 2) return 0;
+  out[o++] = GDL90_FLAG;
+  for (size_t i=0; i<n; ++i) if (!put(out, cap, o, msg[i])) return 0;
+  if (!put(out, cap, o, crc & 0xFF) || !put(out, cap, o, crc >> 8) || o + 1 > cap) return 0;
+  out[o++] = GDL90_FLAG;
+  return o;
+}
+
+// 24-bit two's complement semicircles -> degrees * 1e7
+static int32_t semicircle_e7(const uint8_t* p){
+  int32_t v = ((int32_t)p[0] << 16) | ((int32_t)p[1] << 8) | p[2];
+  if (v & 0x800000) v -= 0x1000000;
+  return (int32_t)((int64_t)v * 1800000000LL / 8388608);
+}
+
+bool gdl90_report(const uint8_t* m, size_t n, Gdl90Report& r){
+  if (n < GDL90_REPORT_LEN || (m[0] != GDL90_OWNSHIP && m[0] != GDL90_TRAFFIC)) return false;
+  r.alert     = m[1] >> 4;
+  r.addr_type = m[1] & 0x0F;
+  r.addr      = ((uint32_t)m[2] << 16) | ((uint32_t)m[3] << 8) | m[4];
+  r.lat_e7    = semicircle_e7(&m[5]);
+  r.lon_e7    = semicircle_e7(&m[8]);
+  const uint16_t ddd = (uint16_t)((m[11] << 4) | (m[12] >> 4));
+  const uint8_t  misc = m[12] & 0x0F;
+  r.alt_ft    = (ddd == 0xFFF) ? INT32_MIN : (int32_t)ddd * 25 - 1000;
+  r.airborne  = misc & 0x08;
+  r.nic       = m[13] >> 4;
+  const uint16_t hhh = (uint16_t)((m[14] << 4) | (m[15] >> 4));
+  int16_t vvv = (int16_t)(((m[15] & 0x0F) << 8) | m[16]);
+  r.gs_kts    = (hhh == 0xFFF) ? NAN : (float)hhh;
+  if (vvv == 0x800) r.vv_fpm = INT16_MIN;
+  else { if (vvv & 0x800) vvv -= 0x1000; r.vv_fpm = (int16_t)(vvv * 64); }
+  r.track_deg = (misc & 0x03) ? m[17] * (360.0f / 256.0f) : NAN;
+  return true;
+}
+
+bool gdl90_heartbeat(const uint8_t* m, size_t n, uint32_t& utc_s, bool& utc_ok, bool& gps_valid){
+  if (n < 7 || m[0] != GDL90_HEARTBEAT) return false;
+  gps_valid = m[1] & 0x80;
+  utc_ok    = m[2] & 0x01;
+  utc_s     = ((uint32_t)(m[2] >> 7) << 16) | ((uint32_t)m[4] << 8) | m[3];
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+
+// GDL90 (RTCA DO-282 / FAA GDL90 ICD) message framing and the reports HALO
+// uses: Heartbeat (0), Ownship (10) and Traffic (20).
+//
+// On the wire a message is [0x7E][id][payload][crc lo][crc hi][0x7E], with
+// 0x7E / 0x7D inside escaped as 0x7D, byte ^ 0x20. The CRC is CRC-16-CCITT
+// (poly 0x1021, init 0) over id + payload. Decoders below take the message
+// unescaped, without flags or CRC.
+static constexpr uint8_t GDL90_FLAG      = 0x7E;
+static constexpr uint8_t GDL90_ESC       = 0x7D;
+static constexpr uint8_t GDL90_HEARTBEAT = 0;
+static constexpr uint8_t GDL90_OWNSHIP   = 10;
+static constexpr uint8_t GDL90_TRAFFIC   = 20;
+static constexpr uint8_t GDL90_REPORT_LEN = 28;          // id + 27 bytes
+
+struct Gdl90Report {
+  uint8_t  alert;          // traffic alert status (0 = none, 1 = alert)
+  uint8_t  addr_type;      // 0 ADS-B ICAO, 1 ADS-B self-assigned, 2 TIS-B ICAO, ...
+  uint32_t addr;           // 24-bit participant address
+  int32_t  lat_e7, lon_e7; // degrees * 1e7
+  int32_t  alt_ft;         // pressure altitude, INT32_MIN = unknown
+  uint8_t  nic;            // 0 = position unknown
+  bool     airborne;
+  float    gs_kts;         // NaN = unknown
+  float    track_deg;      // NaN = invalid
+  int16_t  vv_fpm;         // INT16_MIN = unknown
+};
+
+uint16_t gdl90_crc(const uint8_t* p, size_t n);
+
+// Frame a message (id + payload): flags, CRC and escapes. Returns the bytes
+// written to out, 0 if cap is too small (2 * n + 6 always fits).
+size_t gdl90_frame(uint8_t* out, size_t cap, const uint8_t* msg, size_t n);
+
+bool gdl90_report(const uint8_t* m, size_t n, Gdl90Report& r);          // id 10 or 20
+// Heartbeat: seconds since 0000Z and status flags
+bool gdl90_heartbeat(const uint8_t* m, size_t n, uint32_t& utc_s, bool& utc_ok, bool& gps_valid);
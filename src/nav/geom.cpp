@@ -0,0 +1,63 @@
+#include "geom.h"
+#include "../app/constants.h"
+#include "../app/policy.h"
+#if HALO_GEOM_DSP
+  #include <dsps_mul.h>
+  #include <dsps_add.h>
+#endif
+
+// Per-target tail shared by both paths: everything after the dot products
+// (r2 = |r|^2, v2 = |v|^2, rv = r.v) needs sqrt/divide, which stay scalar;
+// bearing and o'clock come from the fixed-point tables (util/fixed_trig.h).
+static void finish(GeomSet& g, const float* r2, const float* v2, const float* rv, float hdg){
+  const bool hdgOk = !isnan(hdg);
+  const bam16_t hdgBam = hdgOk ? bam_from_deg(hdg) : 0;
+  for (uint8_t i=0; i<g.n; ++i) {
+    const float d = sqrtf(r2[i]);
+    const bam16_t b = iatan2((int32_t)lroundf(g.relE[i]), (int32_t)lroundf(g.relN[i]));   // 1 m grid
+    g.dist[i]    = d;
+    g.brg[i]     = bam_to_deg(b);
+    g.clock[i]   = hdgOk ? clock_sector((bam16_t)(b - hdgBam)) : 0;
+    g.closure[i] = d > 1.0f ? -rv[i] / d : 0.0f;
+
+    if (v2[i] < 1.0f || rv[i] >= 0.0f) {            // < 1 m/s relative, or opening
+      g.tcpa[i] = -1.0f; g.cpa[i] = d; g.cpaV[i] = g.relV[i];
+      continue;
+    }
+    const float tc = fminf(-rv[i] / v2[i], CPA_HORIZON_S);
+    const float n  = g.relN[i] + g.vN[i]*tc, e = g.relE[i] + g.vE[i]*tc;
+    g.tcpa[i] = tc;
+    g.cpa[i]  = sqrtf(n*n + e*e);
+    g.cpaV[i] = g.relV[i] + g.vV[i]*tc;
+  }
+}
+
+void geom_run_scalar(GeomSet& g, float own_hdg_deg){
+  float r2[GEOM_MAX], v2[GEOM_MAX], rv[GEOM_MAX];
+  for (uint8_t i=0; i<g.n; ++i) {
+    r2[i] = g.relN[i]*g.relN[i] + g.relE[i]*g.relE[i];
+    v2[i] = g.vN[i]*g.vN[i]     + g.vE[i]*g.vE[i];
+    rv[i] = g.relN[i]*g.vN[i]   + g.relE[i]*g.vE[i];
+  }
+  finish(g, r2, v2, rv, own_hdg_deg);
+}
+
+#if HALO_GEOM_DSP
+void geom_run(GeomSet& g, float own_hdg_deg){
+  alignas(16) float r2[GEOM_MAX], v2[GEOM_MAX], rv[GEOM_MAX], tmp[GEOM_MAX];
+  const int n = g.n;
+  if (!n) return;
+  dsps_mul_f32(g.relN, g.relN, r2,  n, 1, 1, 1);
+  dsps_mul_f32(g.relE, g.relE, tmp, n, 1, 1, 1);
+  dsps_add_f32(r2, tmp, r2, n, 1, 1, 1);
+  dsps_mul_f32(g.vN, g.vN, v2,  n, 1, 1, 1);
+  dsps_mul_f32(g.vE, g.vE, tmp, n, 1, 1, 1);
+  dsps_add_f32(v2, tmp, v2, n, 1, 1, 1);
+  dsps_mul_f32(g.relN, g.vN, rv,  n, 1, 1, 1);
+  dsps_mul_f32(g.relE, g.vE, tmp, n, 1, 1, 1);
+  dsps_add_f32(rv, tmp, rv, n, 1, 1, 1);
+  finish(g, r2, v2, rv, own_hdg_deg);
+}
+#else
+void geom_run(GeomSet& g, float own_hdg_deg){ geom_run_scalar(g, own_hdg_deg); }
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Batch traffic geometry over a structure-of-arrays target set.
+//
+// traffic_evaluate() packs every live target into a GeomSet and runs one
+// kernel per nav batch: range, absolute bearing, o'clock, closure rate and
+// closest point of approach for the whole set. The products and sums run
+// through esp-dsp's vector routines when it is available (HALO_GEOM_DSP);
+// geom_run_scalar() is the plain-C reference used on other builds and by the
+// benchmark (nav/geom_bench.h, serial key G). No Arduino dependencies, so the
+// kernel also builds on the host.
+static constexpr uint8_t GEOM_MAX = 16;
+
+#ifndef HALO_GEOM_DSP
+  #if defined(ESP_PLATFORM) && __has_include(<dsps_mul.h>)
+    #define HALO_GEOM_DSP 1
+  #else
+    #define HALO_GEOM_DSP 0
+  #endif
+#endif
+
+struct GeomSet {
+  uint8_t n = 0;
+  // inputs (relative to own ship, m and m/s); zero velocity = unknown
+  alignas(16) float relN[GEOM_MAX];
+  alignas(16) float relE[GEOM_MAX];
+  alignas(16) float relV[GEOM_MAX];
+  alignas(16) float vN[GEOM_MAX];
+  alignas(16) float vE[GEOM_MAX];
+  alignas(16) float vV[GEOM_MAX];
+  // outputs
+  alignas(16) float dist[GEOM_MAX];      // horizontal range (m)
+  alignas(16) float brg[GEOM_MAX];       // absolute bearing, 0..360
+  alignas(16) float closure[GEOM_MAX];   // range rate, + closing (m/s)
+  alignas(16) float tcpa[GEOM_MAX];      // s to CPA (capped at CPA_HORIZON_S); < 0 diverging/unknown
+  alignas(16) float cpa[GEOM_MAX];       // horizontal miss at CPA (m)
+  alignas(16) float cpaV[GEOM_MAX];      // vertical separation at CPA (m)
+  uint8_t clock[GEOM_MAX];               // 1..12 relative to own heading, 0 if heading unknown
+};
+
+void geom_run(GeomSet& g, float own_hdg_deg);          // vector path when built in
+void geom_run_scalar(GeomSet& g, float own_hdg_deg);   // reference
@@ -0,0 +1,40 @@
+#include "geom_bench.h"
+#include "geom.h"
+
+static void bench_fill(GeomSet& g){
+  uint32_t x = 0x12345678u;                          // xorshift: same set every run
+  auto rnd = [&x](float lo, float hi){
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return lo + (hi - lo) * (float)(x & 0xFFFF) / 65535.0f;
+  };
+  g.n = GEOM_MAX;
+  for (uint8_t i=0; i<GEOM_MAX; ++i) {
+    g.relN[i] = rnd(-3000, 3000); g.relE[i] = rnd(-3000, 3000); g.relV[i] = rnd(-300, 300);
+    g.vN[i]   = rnd(-60, 60);     g.vE[i]   = rnd(-60, 60);     g.vV[i]   = rnd(-5, 5);
+  }
+}
+
+void geom_bench(Print& out){
+  static GeomSet a, b;                               // ~1.4 KB each: keep off the loop() stack
+  const int ITER = 1000;
+  bench_fill(a); bench_fill(b);
+
+  uint32_t t0 = ESP.getCycleCount();
+  for (int k=0; k<ITER; ++k) geom_run_scalar(a, 90.0f);
+  const uint32_t scalar = ESP.getCycleCount() - t0;
+
+  t0 = ESP.getCycleCount();
+  for (int k=0; k<ITER; ++k) geom_run(b, 90.0f);
+  const uint32_t vec = ESP.getCycleCount() - t0;
+
+  float maxDiff = 0.0f;
+  for (uint8_t i=0; i<GEOM_MAX; ++i) {
+    maxDiff = max(maxDiff, fabsf(a.dist[i] - b.dist[i]));
+    maxDiff = max(maxDiff, fabsf(a.cpa[i]  - b.cpa[i]));
+    maxDiff = max(maxDiff, fabsf(a.tcpa[i] - b.tcpa[i]));
+  }
+  out.printf("[GEOM] %u targets x %d: scalar %lu cyc/batch, %s %lu cyc/batch (%.2fx), max diff %.4f\n",
+             (unsigned)GEOM_MAX, ITER, (unsigned long)(scalar / ITER),
+             HALO_GEOM_DSP ? "esp-dsp" : "scalar(no dsp)", (unsigned long)(vec / ITER),
+             vec ? (double)scalar / (double)vec : 0.0, (double)maxDiff);
+}
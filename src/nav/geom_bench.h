@@ -0,0 +1,7 @@
+#pragma once
+#include <Arduino.h>
+
+// Serial key G: time geom_run_scalar() against geom_run() (esp-dsp when built
+// in) on a synthetic full GeomSet and check that they agree. Kept apart from
+// nav/geom.cpp so the kernel itself builds on the host.
+void geom_bench(Print& out);
@@ -0,0 +1,37 @@
+#include "heading.h"
+#include "../app/constants.h"
+
+static float    prevTrk = NAN;
+static uint32_t prevMs  = 0;
+
+static inline float wrap180(float d){
+  while (d >  180.0f) d -= 360.0f;
+  while (d < -180.0f) d += 360.0f;
+  return d;
+}
+
+void heading_on_fix(float track_deg, float sog_kts, uint32_t now){
+  const uint32_t dt_ms = now - prevMs;
+  float rate = 0.0f;
+  if (!isnan(prevTrk) && sog_kts >= HEADING_MIN_KTS && dt_ms >= 200 && dt_ms <= HEADING_FIX_GAP_MS) {
+    rate = constrain(wrap180(track_deg - prevTrk) * 1000.0f / (float)dt_ms, -HEADING_MAX_DPS, HEADING_MAX_DPS);
+    rate = HEADING_RATE_ALPHA * rate + (1.0f - HEADING_RATE_ALPHA) * tele.turn_dps;
+  }
+  prevTrk = track_deg; prevMs = now;
+
+  tele.track_deg = track_deg;
+  tele.turn_dps  = rate;
+  tele.track_ms  = now;
+}
+
+float heading_at(const Telemetry& t, uint32_t at){
+  if (isnan(t.track_deg)) return NAN;
+  if (t.turn_dps == 0.0f) return t.track_deg;
+  // RMC arrives HEADING_FIX_LAG_MS after its epoch; predict from the epoch.
+  // `at` may predate track_ms (a snapshot taken before the fix landed): signed.
+  const int32_t since = max<int32_t>((int32_t)(at - t.track_ms), 0);
+  const uint32_t age  = min<uint32_t>((uint32_t)since + HEADING_FIX_LAG_MS, HEADING_PREDICT_MAX_MS);
+  float h = t.track_deg + t.turn_dps * (float)age / 1000.0f;
+  h = fmodf(h, 360.0f); if (h < 0) h += 360.0f;
+  return h;
+}
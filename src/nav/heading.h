@@ -0,0 +1,17 @@
+#pragma once
+#include <Arduino.h>
+#include "../app/telemetry.h"
+
+// Own-ship heading between RMC fixes (1 Hz on most FLARMs).
+//
+// Each valid RMC updates a smoothed turn rate from the track change since the
+// previous fix; heading_at() extrapolates the last track with it. Below
+// HEADING_MIN_KTS, or after a fix gap, the rate is zeroed (ground track is noise
+// there) and heading_at() just returns the last track.
+
+// Parser hook (control task): writes tele.track_deg / turn_dps / track_ms
+void  heading_on_fix(float track_deg, float sog_kts, uint32_t now);
+
+// Track predicted for time `at` (millis), from a telemetry snapshot; NaN if unknown.
+// Extrapolation is capped at HEADING_PREDICT_MAX_MS past the fix.
+float heading_at(const Telemetry& t, uint32_t at);
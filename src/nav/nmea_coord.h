@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+// NMEA "ddmm.mmmm" / "dddmm.mmmm" + hemisphere -> degrees * 1e7, in integers
+// (minutes keep 5 decimals, ~2 cm; further digits are ignored). False for a
+// malformed field, a hemisphere other than N/S/E/W, minutes >= 60 or degrees
+// out of range. No Arduino dependencies, so it builds on the host.
+inline bool nmea_coord_e7(const char* t, char hemi, int32_t& out){
+  const char* dot = strchr(t, '.');
+  const int ilen = dot ? (int)(dot - t) : (int)strlen(t);
+  if (ilen < 3 || ilen > 5) return false;
+  int32_t deg = 0, min_e5 = 0;
+  for (int i=0; i<ilen; ++i) {
+    if (!isdigit((unsigned char)t[i])) return false;
+    if (i < ilen - 2) deg = deg * 10 + (t[i] - '0'); else min_e5 = min_e5 * 10 + (t[i] - '0');
+  }
+  int32_t scale = 100000;
+  for (const char* f = dot ? dot + 1 : ""; *f && scale > 1; ++f) {
+    if (!isdigit((unsigned char)*f)) return false;
+    min_e5 = min_e5 * 10 + (*f - '0'); scale /= 10;
+  }
+  min_e5 *= scale;
+  const bool isLon = (hemi == 'E' || hemi == 'W');
+  if ((!isLon && hemi != 'N' && hemi != 'S') || min_e5 >= 6000000 || deg > (isLon ? 179 : 89)) return false;
+  const int32_t v = deg * 10000000 + min_e5 * 5 / 3;     // 1 min = 1e7/60 e7-degrees
+  out = (hemi == 'S' || hemi == 'W') ? -v : v;
+  return true;
+}
@@ -0,0 +1,233 @@
+#include "traffic.h"
+#include "../app/telemetry.h"
+#include "../app/constants.h"
+#include "../util/spsc_queue.h"
+#include "flarm.h"
+#include "geom.h"
+#include "heading.h"
+
+static TrafficTarget tbl[TRAFFIC_MAX];
+static_assert(TRAFFIC_MAX <= GEOM_MAX, "geometry batch must hold the whole table");
+static int8_t   primary      = -1;
+static uint32_t primarySince = 0;
+static uint8_t  pubLevel     = 0;      // published alarm level (with step-down delay)
+static uint32_t lowerSince   = 0;
+static bool     calloutDue   = false;
+static bool     calloutEsc   = false;
+static uint8_t  anonSeq      = 0;      // ID-less PFLAA sentences in the current batch
+static SpscQueue<TrafficEpisode, 8> closed;         // producer and consumer both on the control task
+
+static void episode_close(TrafficTarget& t){
+  if (!t.ep_open) return;
+  t.ep_open = false;
+  TrafficEpisode e;
+  e.id          = t.id;
+  e.start_utc   = t.ep_start_utc;
+  e.duration_ms = t.ep_last_ms - t.ep_start_ms;
+  e.min_dist_m  = t.ep_min_dist_m;
+  e.min_vert_m  = t.ep_min_vert_m;
+  e.min_brg_deg = t.ep_min_brg_deg;
+  e.own_trk_deg = t.ep_min_trk_deg;
+  e.max_level   = t.ep_max_level;
+  closed.push(e);                                   // full: oldest unread kept, this one lost
+}
+
+static void episode_update(TrafficTarget& t, uint32_t now){
+  if (t.level >= 1) {
+    if (!t.ep_open) {
+      t.ep_open = true; t.ep_start_ms = now; t.ep_start_utc = nav_utc_now();
+      t.ep_max_level = 0; t.ep_min_dist_m = INFINITY;
+    }
+    t.ep_last_ms   = now;
+    t.ep_max_level = max(t.ep_max_level, t.level);
+  }
+  if (t.ep_open && t.dist_m < t.ep_min_dist_m) {
+    t.ep_min_dist_m = t.dist_m; t.ep_min_vert_m = t.relV_m;
+    t.ep_min_brg_deg = t.bearing_deg; t.ep_min_trk_deg = tele.track_deg;
+  }
+}
+
+static TrafficTarget* slot_for(uint32_t id){
+  TrafficTarget* freeSlot = nullptr;
+  TrafficTarget* oldest   = &tbl[0];
+  for (uint8_t i=0; i<TRAFFIC_MAX; ++i) {
+    TrafficTarget& t = tbl[i];
+    if (t.used && t.id == id) return &t;
+    if (!t.used && !freeSlot) freeSlot = &t;
+    if (t.used && (int32_t)(t.seen_ms - oldest->seen_ms) < 0) oldest = &t;
+  }
+  TrafficTarget* t = freeSlot ? freeSlot : oldest;   // table full: recycle the stalest
+  if (t - tbl == primary) primary = -1;
+  episode_close(*t);
+  *t = TrafficTarget{};
+  t->id = id;
+  return t;
+}
+
+// CPA-derived level: converging to within the miss limits, banded by time to CPA
+static uint8_t cpa_level(const TrafficTarget& t){
+  if (t.vel_n < CPA_MIN_VEL_SAMPLES) return 0;
+  if (t.tcpa_s < 0.0f || t.cpa_m > CPA_MISS_M || fabsf(t.cpaV_m) > CPA_MISS_VERT_M) return 0;
+  return (t.tcpa_s <= CPA_L3_S) ? 3 : (t.tcpa_s <= CPA_L2_S) ? 2 : (t.tcpa_s <= CPA_L1_S) ? 1 : 0;
+}
+
+void traffic_update(uint32_t id, uint8_t alarm, float relN_m, float relE_m, float relV_m,
+                    uint32_t rx_us, uint32_t now){
+  const bool anon = (id == TRAFFIC_NO_ID);
+  if (anon) id = TRAFFIC_NO_ID | anonSeq++;      // k-th ID-less target of this batch
+  TrafficTarget* t = slot_for(id);
+
+  // Relative velocity from successive fixes (smoothed); gaps too short or too
+  // long to difference restart the estimate. ID-less keys may pair up two
+  // different aircraft, so they never get one.
+  const uint32_t dt_ms = now - t->seen_ms;
+  if (anon) { t->vel_ok = false; t->vel_n = 0; }
+  else if (t->used && dt_ms >= 200 && dt_ms <= TRAFFIC_STALE_MS) {
+    const float k  = 1000.0f / (float)dt_ms;
+    const float vn = (relN_m - t->relN_m) * k, ve = (relE_m - t->relE_m) * k, vv = (relV_m - t->relV_m) * k;
+    if (t->vel_ok) {
+      t->vN_ms = 0.5f*t->vN_ms + 0.5f*vn; t->vE_ms = 0.5f*t->vE_ms + 0.5f*ve; t->vV_ms = 0.5f*t->vV_ms + 0.5f*vv;
+      if (t->vel_n < 255) t->vel_n++;
+    } else {
+      t->vN_ms = vn; t->vE_ms = ve; t->vV_ms = vv; t->vel_ok = true; t->vel_n = 1;
+    }
+  } else if (t->used && dt_ms > TRAFFIC_STALE_MS) { t->vel_ok = false; t->vel_n = 0; }
+
+  // Geometry (range, bearing, CPA) and episodes follow in traffic_evaluate()
+  t->used        = true;
+  t->fresh       = true;
+  t->seen_ms     = now;
+  t->rx_us       = rx_us;
+  t->relN_m      = relN_m; t->relE_m = relE_m; t->relV_m = relV_m;
+  t->alarm       = alarm;
+}
+
+void traffic_extrapolate(const TrafficAlert& a, uint32_t now, float& relN_m, float& relE_m, float& relV_m){
+  const float dt = (float)min<uint32_t>(now - a.since, TRAFFIC_DR_MAX_MS) / 1000.0f;
+  relN_m = a.relN_m + a.vN_ms * dt;
+  relE_m = a.relE_m + a.vE_ms * dt;
+  relV_m = a.relV_m + a.vV_ms * dt;
+}
+
+// Alarm level dominates; within a level, nearer, more co-altitude and faster
+// closing targets score higher. Non-threats score 0.
+static float score(const TrafficTarget& t){
+  const float av = fabsf(t.relV_m);
+  if (t.level == 0 && (t.dist_m > TRAFFIC_PROX_M || av > TRAFFIC_PROX_VERT_M)) return 0.0f;
+  float s = 1000.0f * t.level + 100.0f;
+  s += 300.0f * max(0.0f, 1.0f - t.dist_m / 3000.0f);
+  s += 200.0f * max(0.0f, 1.0f - av / TRAFFIC_PROX_VERT_M);
+  s += 2.0f   * constrain(t.closure_ms, 0.0f, 100.0f);
+  return s;
+}
+
+void traffic_evaluate(uint32_t now){
+  // Pass 1: age out, and pack live targets for the geometry kernel
+  static GeomSet g;
+  static uint8_t slotOf[TRAFFIC_MAX];
+  g.n = 0;
+  anonSeq = 0;
+  for (uint8_t i=0; i<TRAFFIC_MAX; ++i) {
+    TrafficTarget& t = tbl[i];
+    if (!t.used) continue;
+    const bool quiet = !t.ep_open || now - t.ep_last_ms >= EPISODE_QUIET_MS;
+    if (t.ep_open && quiet) episode_close(t);
+    if (now - t.seen_ms > TRAFFIC_STALE_MS) {
+      t.score = 0.0f;
+      if (i == primary) primary = -1;
+      if (quiet) t.used = false;                      // else hold the slot for the episode
+      continue;
+    }
+    const uint8_t k = g.n++;
+    slotOf[k]  = i;
+    g.relN[k]  = t.relN_m; g.relE[k] = t.relE_m; g.relV[k] = t.relV_m;
+    g.vN[k]    = t.vel_ok ? t.vN_ms : 0.0f;
+    g.vE[k]    = t.vel_ok ? t.vE_ms : 0.0f;
+    g.vV[k]    = t.vel_ok ? t.vV_ms : 0.0f;
+  }
+
+  geom_run(g, heading_at(tele, now));
+
+  // Pass 2: unpack, level, episodes, score
+  int8_t best = -1;
+  for (uint8_t k=0; k<g.n; ++k) {
+    const uint8_t i = slotOf[k];
+    TrafficTarget& t = tbl[i];
+    t.dist_m      = g.dist[k];
+    t.bearing_deg = g.brg[k];
+    t.clock       = g.clock[k];
+    t.closure_ms  = g.closure[k];
+    t.tcpa_s      = g.tcpa[k];
+    t.cpa_m       = g.cpa[k];
+    t.cpaV_m      = g.cpaV[k];
+    t.cpa_level   = cpa_level(t);
+    t.level       = max(t.alarm, min<uint8_t>(t.cpa_level, t.alarm + 1));
+    if (t.fresh) { episode_update(t, t.seen_ms); t.fresh = false; }
+    t.score = score(t);
+    if (t.score > 0 && (best < 0 || t.score > tbl[best].score)) best = (int8_t)i;
+  }
+  if (primary >= 0 && tbl[primary].score <= 0) primary = -1;
+
+  // Primary selection with dwell + margin; a higher alarm level always wins
+  if (best >= 0 && best != primary) {
+    bool take = (primary < 0);
+    if (!take) {
+      const TrafficTarget& cur = tbl[primary];
+      const TrafficTarget& ch  = tbl[best];
+      take = ch.level > cur.level
+          || (now - primarySince >= THREAT_MIN_DWELL_MS && ch.score > cur.score * THREAT_SWITCH_MARGIN);
+    }
+    if (take) {
+      primary = best; primarySince = now;
+      pubLevel = tbl[best].level; lowerSince = 0;
+      calloutDue = true; calloutEsc = false;
+    }
+  }
+  if (primary < 0) return;       // `alert` ages out on its own (ALERT_HOLD_MS)
+
+  // Published level: up at once, down only after a steady lower level
+  const TrafficTarget& p = tbl[primary];
+  if (p.level > pubLevel || !alert.active) {
+    if (p.level > pubLevel && alert.active) { calloutDue = true; calloutEsc = true; }
+    pubLevel = p.level; lowerSince = 0;
+  } else if (p.level < pubLevel) {
+    if (!lowerSince) lowerSince = now ? now : 1;
+    if (now - lowerSince >= THREAT_LEVEL_DOWN_MS) { pubLevel = p.level; lowerSince = 0; }
+  } else lowerSince = 0;
+
+  if (alert.since == p.seen_ms && alert.id == p.id && alert.alarm == pubLevel) return;   // nothing new
+  alert.active      = true;
+  alert.since       = p.seen_ms;
+  alert.id          = p.id;
+  alert.relN_m      = p.relN_m; alert.relE_m = p.relE_m; alert.relV_m = p.relV_m;
+  alert.dist_m      = p.dist_m;
+  alert.bearing_deg = p.bearing_deg;
+  alert.alarm       = pubLevel;
+  alert.rx_us       = p.rx_us;
+  alert.vN_ms       = p.vel_ok ? p.vN_ms : 0.0f;
+  alert.vE_ms       = p.vel_ok ? p.vE_ms : 0.0f;
+  alert.vV_ms       = p.vel_ok ? p.vV_ms : 0.0f;
+  alert.tcpa_s      = p.tcpa_s;
+  alert.cpa_m       = p.cpa_m;
+}
+
+uint8_t traffic_count(){
+  uint8_t n = 0;
+  for (uint8_t i=0; i<TRAFFIC_MAX; ++i) n += tbl[i].used;
+  return n;
+}
+
+const TrafficTarget* traffic_primary(){ return primary >= 0 ? &tbl[primary] : nullptr; }
+
+bool traffic_take_episode(TrafficEpisode& out){ return closed.pop(out); }
+
+void traffic_close_episodes(){
+  for (uint8_t i=0; i<TRAFFIC_MAX; ++i) if (tbl[i].used) episode_close(tbl[i]);
+}
+
+bool traffic_take_callout(bool& escalation){
+  if (!calloutDue) return false;
+  escalation = calloutEsc;
+  calloutDue = calloutEsc = false;
+  return true;
+}
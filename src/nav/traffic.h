@@ -0,0 +1,97 @@
+#pragma once
+#include <Arduino.h>
+#include "../app/telemetry.h"
+
+// Traffic table and threat selection.
+//
+// Every PFLAA sentence updates one slot (keyed by FLARM ID) in a fixed table;
+// after each batch of NMEA lines traffic_evaluate() runs the geometry for all
+// live targets in one batch (nav/geom.h), scores them and picks the primary
+// threat, which is what `alert` then shows. Selection has hysteresis: the
+// primary is kept for THREAT_MIN_DWELL_MS unless it goes stale or a
+// challenger has a higher alarm level, and a challenger must beat it by
+// THREAT_SWITCH_MARGIN. The published alarm level rises at once and falls
+// only after THREAT_LEVEL_DOWN_MS. Both calls are O(TRAFFIC_MAX).
+//
+// Each target also carries a relative velocity differenced from successive
+// fixes, and the closest point of approach it implies. A target converging to
+// within CPA_MISS_M gets a CPA-derived alarm level (FLARM-like time bands),
+// so fast closers alert before the sender's own alarm says so. Differenced
+// velocities are noisy, so that level only counts once the estimate has
+// CPA_MIN_VEL_SAMPLES samples, and it raises the PFLAA alarm by one step at
+// most.
+//
+// A PFLAA without a usable ID (empty or not hex) is passed as TRAFFIC_NO_ID
+// and keyed by its position among the ID-less sentences of the batch, so two
+// such targets never share a slot within one batch. The key says nothing
+// about identity across batches, so these targets get no velocity estimate
+// (and no CPA promotion).
+//
+// Episodes: a target's first alarm (level >= 1) opens an episode, which then
+// tracks max level and closest range in O(1) per sentence. It closes once the
+// target has been quiet (no alarm) for EPISODE_QUIET_MS, and is queued for
+// traffic_take_episode(). A stale target's slot is held until then, so a
+// dropout inside one encounter doesn't split it.
+static constexpr uint8_t TRAFFIC_MAX = 16;
+static constexpr uint32_t TRAFFIC_NO_ID = 0xFF000000;   // ID type 0xFF is not used by FLARM
+
+struct TrafficTarget {
+  uint32_t id;           // (ID type << 24) | 24-bit FLARM ID
+  uint32_t seen_ms;      // millis() of the last PFLAA
+  uint32_t rx_us;        // latency trace tag of the last PFLAA
+  float    relN_m, relE_m, relV_m;
+  float    dist_m;
+  float    bearing_deg;  // absolute, 0..360
+  float    vN_ms, vE_ms, vV_ms;   // relative velocity (m/s, smoothed)
+  float    closure_ms;   // range rate, positive when closing (m/s)
+  uint8_t  clock;        // 1..12 o'clock from own heading, 0 = unknown
+  float    tcpa_s;       // time to CPA (s); < 0 when diverging or unknown
+  float    cpa_m;        // horizontal miss distance at CPA (m)
+  float    cpaV_m;       // vertical separation at CPA (m)
+  float    score;
+  uint8_t  alarm;        // as reported by PFLAA
+  uint8_t  cpa_level;    // 0..3 from the CPA prediction
+  uint8_t  level;        // alarm, raised by cpa_level (at most +1): what scoring and `alert` use
+  uint8_t  vel_n;        // samples in the velocity estimate since it (re)started
+  bool     vel_ok;
+  bool     fresh;        // new PFLAA since the last traffic_evaluate()
+  bool     used;
+
+  // Open episode (ep_open) bookkeeping
+  bool     ep_open;
+  uint8_t  ep_max_level;
+  uint32_t ep_start_ms, ep_last_ms;   // first / latest alarm
+  uint32_t ep_start_utc;
+  float    ep_min_dist_m, ep_min_vert_m, ep_min_brg_deg, ep_min_trk_deg;   // at closest range
+};
+
+struct TrafficEpisode {
+  uint32_t id;
+  uint32_t start_utc;        // 0 = unknown
+  uint32_t duration_ms;      // first -> last alarm
+  float    min_dist_m;
+  float    min_vert_m;       // relative vertical at the closest range
+  float    min_brg_deg;      // absolute bearing at the closest range
+  float    own_trk_deg;      // own track then (NaN if unknown)
+  uint8_t  max_level;
+};
+
+// Parser hook (control task): one PFLAA sentence
+void traffic_update(uint32_t id, uint8_t alarm, float relN_m, float relE_m, float relV_m,
+                    uint32_t rx_us, uint32_t now);
+// After each nav batch (control task): age out, score, select, publish to `alert`
+void traffic_evaluate(uint32_t now);
+
+// Dead-reckoned relative position of an alert snapshot at `now` (UI animation);
+// extrapolation stops TRAFFIC_DR_MAX_MS after the last fix.
+void traffic_extrapolate(const TrafficAlert& a, uint32_t now, float& relN_m, float& relE_m, float& relV_m);
+
+uint8_t traffic_count();                            // live targets
+const TrafficTarget* traffic_primary();             // nullptr if none
+
+// A new primary or a level escalation since the last call (for audio callouts)
+bool traffic_take_callout(bool& escalation);
+
+// Closed episodes, oldest first (control task)
+bool traffic_take_episode(TrafficEpisode& out);
+void traffic_close_episodes();                      // close all open ones now (e.g. at landing)
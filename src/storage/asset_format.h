@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+
+// On-flash layout of the asset partition (storage/assets.h), shared with
+// tools/mkassets.py and tools/mkairfields.py. Plain structs only, so host
+// tools and tests can include it.
+//
+// Image layout (little-endian, payloads 4-byte aligned):
+//   AssetHeader, AssetEntry[count], payloads...
+static constexpr uint32_t ASSETS_MAGIC   = 0x54534148;   // "HAST"
+static constexpr uint16_t ASSETS_VERSION = 1;
+
+enum AssetType : uint16_t {
+  ASSET_IMAGE    = 1,   // AssetImage + RGB565[w*h]
+  ASSET_FONT     = 2,   // AssetFont + GFXglyph[last-first+1] + bitmap bytes (Adafruit GFX)
+  // 3 is reserved
+  ASSET_MANIFEST = 4,   // AssetManifest + AssetPrompt[count]
+  ASSET_AIRFIELDS = 5,  // AssetAirfields + AssetAirfieldCell[ncells+1] + AssetAirfield[count]
+};
+
+struct AssetHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+  uint32_t dir_crc;     // CRC-32 (zlib) of the entry table
+  uint32_t total;       // bytes used from the start of the partition
+};
+struct AssetEntry {
+  char     name[20];    // NUL-padded
+  uint16_t type;        // AssetType
+  uint16_t reserved;
+  uint32_t offset;      // from the start of the partition
+  uint32_t size;
+};
+struct AssetImage    { uint16_t w, h; };
+struct AssetFont     { uint8_t first, last, yAdvance, reserved; };
+struct AssetManifest { uint16_t count, reserved; };
+struct AssetPrompt   { char name[12]; uint16_t track; uint16_t reserved; };
+// Airfields are bucketed into a lat/lon grid of cell_e7-degree cells from
+// (lat0, lon0). Only non-empty cells are listed, sorted by id = row*cols+col;
+// cell k holds records cells[k].start .. cells[k+1].start (the last entry is
+// a sentinel with id 0xFFFFFFFF and start = count).
+struct AssetAirfields    { int32_t lat0_e7, lon0_e7; uint32_t cell_e7; uint16_t rows, cols; uint32_t count, ncells; };
+struct AssetAirfieldCell { uint32_t id, start; };
+struct AssetAirfield     { int32_t lat_e7, lon_e7; int16_t elev_ft; char ident[6]; };
+static_assert(sizeof(AssetHeader) == 16 && sizeof(AssetEntry) == 32, "asset layout is flashed");
+static_assert(sizeof(AssetPrompt) == 16, "asset layout is flashed");
+static_assert(sizeof(AssetAirfields) == 24 && sizeof(AssetAirfield) == 16, "asset layout is flashed");
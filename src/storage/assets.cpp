@@ -0,0 +1,122 @@
+#include "assets.h"
+#include <esp_partition.h>
+
+static const uint8_t MAX_FONTS = 4;
+
+static const uint8_t*     base    = nullptr;    // mapped partition
+static const AssetEntry*  dir     = nullptr;
+static uint16_t           count   = 0;
+static spi_flash_mmap_handle_t map_handle;
+static GFXfont            fonts[MAX_FONTS];     // RAM descriptors pointing into flash
+static const AssetEntry*  fontEntry[MAX_FONTS];
+
+static uint32_t crc32_zlib(const uint8_t* p, size_t n){
+  uint32_t crc = 0xFFFFFFFFu;
+  while (n--) {
+    crc ^= *p++;
+    for (int i=0; i<8; ++i) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+static bool font_entry_ok(const AssetEntry& e){
+  if (e.size < sizeof(AssetFont)) return false;
+  const AssetFont* f = (const AssetFont*)(base + e.offset);
+  if (f->last < f->first) return false;
+  return e.size >= sizeof(AssetFont) + (f->last - f->first + 1u) * sizeof(GFXglyph);
+}
+
+bool assets_begin(){
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "assets");
+  if (!part) { Serial.println("[ASSETS] partition 'assets' not found"); return false; }
+
+  const void* p = nullptr;
+  if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &p, &map_handle) != ESP_OK) {
+    Serial.println("[ASSETS] mmap FAILED");
+    return false;
+  }
+  const uint8_t* b = (const uint8_t*)p;
+  const AssetHeader* h = (const AssetHeader*)b;
+  const uint32_t dirEnd = sizeof(AssetHeader) + (uint32_t)h->count * sizeof(AssetEntry);
+  const char* why = nullptr;
+  if (h->magic != ASSETS_MAGIC)                                   why = "no image";
+  else if (h->version != ASSETS_VERSION)                          why = "version mismatch";
+  else if (dirEnd > part->size || h->total > part->size)          why = "bad size";
+  else if (crc32_zlib(b + sizeof(AssetHeader), dirEnd - sizeof(AssetHeader)) != h->dir_crc) why = "directory CRC";
+  if (!why) {
+    const AssetEntry* d = (const AssetEntry*)(b + sizeof(AssetHeader));
+    for (uint16_t i=0; i<h->count && !why; ++i)
+      if ((d[i].offset & 3) || d[i].offset < dirEnd || d[i].offset + d[i].size > h->total) why = "entry out of range";
+  }
+  if (why) {
+    Serial.printf("[ASSETS] %s, using built-in defaults\n", why);
+    spi_flash_munmap(map_handle);
+    return false;
+  }
+
+  base  = b;
+  dir   = (const AssetEntry*)(b + sizeof(AssetHeader));
+  count = h->count;
+
+  // GFX wants a GFXfont struct; build those once so lookups stay lock-free
+  uint8_t nf = 0;
+  for (uint16_t i=0; i<count && nf < MAX_FONTS; ++i) {
+    if (dir[i].type != ASSET_FONT || !font_entry_ok(dir[i])) continue;
+    const AssetFont* f = (const AssetFont*)(base + dir[i].offset);
+    const GFXglyph* glyphs = (const GFXglyph*)(f + 1);
+    fonts[nf].bitmap   = (uint8_t*)(glyphs + (f->last - f->first + 1));
+    fonts[nf].glyph    = (GFXglyph*)glyphs;
+    fonts[nf].first    = f->first;
+    fonts[nf].last     = f->last;
+    fonts[nf].yAdvance = f->yAdvance;
+    fontEntry[nf++]    = &dir[i];
+  }
+  Serial.printf("[ASSETS] %u assets, %lu bytes mapped\n", (unsigned)count, (unsigned long)h->total);
+  return true;
+}
+
+bool assets_ok(){ return base != nullptr; }
+
+const void* assets_find(const char* name, AssetType type, uint32_t* size){
+  for (uint16_t i=0; i<count; ++i) {
+    if (dir[i].type != type || strncmp(dir[i].name, name, sizeof(dir[i].name)) != 0) continue;
+    if (size) *size = dir[i].size;
+    return base + dir[i].offset;
+  }
+  return nullptr;
+}
+
+const uint16_t* assets_image(const char* name, uint16_t& w, uint16_t& h){
+  uint32_t n = 0;
+  const AssetImage* img = (const AssetImage*)assets_find(name, ASSET_IMAGE, &n);
+  if (!img || n < sizeof(AssetImage) || n < sizeof(AssetImage) + 2u * img->w * img->h) return nullptr;
+  w = img->w; h = img->h;
+  return (const uint16_t*)(img + 1);
+}
+
+
+const GFXfont* assets_font(const char* name){
+  for (uint8_t i=0; i<MAX_FONTS && fontEntry[i]; ++i)
+    if (!strncmp(fontEntry[i]->name, name, sizeof(fontEntry[i]->name))) return &fonts[i];
+  return nullptr;
+}
+
+const AssetPrompt* assets_manifest(const char* name, uint16_t& n){
+  uint32_t sz = 0;
+  const AssetManifest* m = (const AssetManifest*)assets_find(name, ASSET_MANIFEST, &sz);
+  if (!m || sz < sizeof(AssetManifest) || sz < sizeof(AssetManifest) + m->count * sizeof(AssetPrompt)) return nullptr;
+  n = m->count;
+  return (const AssetPrompt*)(m + 1);
+}
+
+void assets_dump(Print& out){
+  if (!base) { out.printf("[ASSETS] none mapped\n"); return; }
+  out.printf("[ASSETS] %u assets\n", (unsigned)count);
+  static const char* const TYPES[] = { "?", "image", "font", "?", "manifest", "airfield" };
+  for (uint16_t i=0; i<count; ++i) {
+    char name[sizeof(dir[i].name) + 1];
+    memcpy(name, dir[i].name, sizeof(dir[i].name)); name[sizeof(dir[i].name)] = '\0';
+    out.printf("  %-20s %-8s @0x%05lX %lu B\n", name, dir[i].type <= ASSET_AIRFIELDS ? TYPES[dir[i].type] : "?",
+               (unsigned long)dir[i].offset, (unsigned long)dir[i].size);
+  }
+}
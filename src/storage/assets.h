@@ -0,0 +1,28 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "asset_format.h"
+
+// Read-only asset partition ("assets"): splash, fonts, the audio prompt
+// manifest and the airfield database, built off-target by tools/mkassets.py and flashed on
+// its own, so they change without a firmware rebuild.
+//
+// The whole partition is mapped once with esp_partition_mmap(); every lookup
+// returns a pointer straight into flash (through the cache), so nothing is
+// copied to RAM. A missing or invalid image leaves every lookup empty and the
+// callers fall back to the compiled-in defaults.
+//
+// Image layout: storage/asset_format.h.
+
+static_assert(sizeof(GFXglyph) == 8, "asset layout is flashed");
+
+bool        assets_begin();                      // map + validate; false = no assets
+bool        assets_ok();
+const void* assets_find(const char* name, AssetType type, uint32_t* size = nullptr);
+
+// Typed views (nullptr if absent or malformed)
+const uint16_t*      assets_image(const char* name, uint16_t& w, uint16_t& h);
+const GFXfont*       assets_font(const char* name);   // for tft.setFont()
+const AssetPrompt*   assets_manifest(const char* name, uint16_t& count);
+
+void        assets_dump(Print& out);             // directory listing
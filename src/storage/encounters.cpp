@@ -0,0 +1,99 @@
+#include "encounters.h"
+#include "flash_ring.h"
+#include "../util/spsc_queue.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <time.h>
+
+static FlashRing ring;
+static bool      mounted = false;
+static SemaphoreHandle_t ringLock = nullptr;  // loop() appends vs. BLE bulk reads on the control task
+static SpscQueue<EncounterRecord, 8> pending;      // control task -> loop()
+static volatile uint32_t dropped = 0;
+
+bool encounters_begin(){
+  if (!ringLock) ringLock = xSemaphoreCreateMutex();
+  mounted = fring_open(ring, "encounters", sizeof(EncounterRecord));
+  return mounted;
+}
+
+bool encounters_append(const EncounterRecord& e){
+  if (!mounted) return false;
+  if (pending.push(e)) return true;
+  dropped++;
+  return false;
+}
+
+void encounters_service(){
+  EncounterRecord e;
+  while (pending.pop(e)) {
+    xSemaphoreTake(ringLock, portMAX_DELAY);
+    bool ok = fring_append(ring, &e);
+    xSemaphoreGive(ringLock);
+    if (!ok) Serial.println("[ENC] append FAILED");
+  }
+  if (dropped) {
+    Serial.printf("[ENC] %lu record(s) dropped (queue full)\n", (unsigned long)dropped);
+    dropped = 0;
+  }
+}
+
+uint32_t encounters_count(){
+  if (!mounted) return 0;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  uint32_t n = fring_count(ring);
+  xSemaphoreGive(ringLock);
+  return n;
+}
+
+bool encounters_read(uint32_t index, EncounterRecord& out, uint32_t* seq){
+  if (!mounted) return false;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  bool ok = fring_read(ring, index, &out, seq);
+  xSemaphoreGive(ringLock);
+  return ok;
+}
+
+void encounters_dump(Print& out){
+  uint32_t n = encounters_count();
+  out.printf("[ENC] %lu encounters\n", (unsigned long)n);
+  for (uint32_t i=0; i<n; ++i) {
+    EncounterRecord e; uint32_t no = 0;
+    if (!encounters_read(i, e, &no)) { out.printf("#%lu <corrupt>\n", (unsigned long)i); continue; }
+    char t0[20];
+    if (e.start_utc) { time_t tt = (time_t)e.start_utc; struct tm tmv; gmtime_r(&tt, &tmv); strftime(t0, sizeof(t0), "%Y-%m-%d %H:%M:%S", &tmv); }
+    else snprintf(t0, sizeof(t0), "----------- --:--:--");
+    char clk[8];
+    if (e.clock) snprintf(clk, sizeof(clk), "%u o'c", (unsigned)e.clock); else snprintf(clk, sizeof(clk), "--");
+    out.printf("#%lu %s  id %u:%06lX  %us  L%u  min %um dAlt %dm @ %s\n",
+               (unsigned long)no, t0, (unsigned)(e.id >> 24), (unsigned long)(e.id & 0xFFFFFF),
+               (unsigned)e.duration_s, (unsigned)e.max_level, (unsigned)e.min_dist_m, (int)e.min_vert_m, clk);
+  }
+}
+
+bool encounters_clear(){
+  if (!mounted) return false;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  bool ok = fring_clear(ring);
+  xSemaphoreGive(ringLock);
+  return ok;
+}
+
+// Bulk download runs on the control task: never wait behind an append/erase
+bool encounters_stream_range(uint32_t& begin, uint32_t& end){
+  begin = end = 0;
+  if (!mounted) return true;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return false;
+  begin = fring_stream_begin(ring);
+  end   = fring_stream_end(ring);
+  xSemaphoreGive(ringLock);
+  return true;
+}
+
+size_t encounters_stream_read(uint32_t& pos, uint8_t* dst, size_t len){
+  if (!mounted) return 0;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return FRING_BUSY;
+  size_t n = fring_stream_read(ring, pos, dst, len);
+  xSemaphoreGive(ringLock);
+  return n;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// One fixed-size record per closed traffic episode (nav/traffic.h), in the
+// "encounters" flash ring. Appends are queued from the control task and
+// written by encounters_service() in loop(), so the alert path never waits on
+// a sector erase.
+struct EncounterRecord {
+  uint32_t start_utc   = 0;        // unix seconds, 0 = unknown
+  uint32_t id          = 0;        // (ID type << 24) | FLARM ID
+  uint16_t duration_s  = 0;        // first alarm -> last alarm
+  uint16_t min_dist_m  = 0xFFFF;   // closest horizontal range during the episode
+  int16_t  min_vert_m  = 0;        // relative vertical at the closest range
+  uint8_t  max_level   = 0;        // 1..3
+  uint8_t  clock       = 0;        // o'clock at the closest range, 0 = unknown heading
+};
+static_assert(sizeof(EncounterRecord) == 16, "encounter record layout is persisted");
+
+bool     encounters_begin();                        // mount the "encounters" partition
+bool     encounters_append(const EncounterRecord& e);   // queue; false if full
+void     encounters_service();                      // loop(): write queued records
+uint32_t encounters_count();
+bool     encounters_read(uint32_t index, EncounterRecord& out, uint32_t* seq = nullptr); // 0 = oldest
+void     encounters_dump(Print& out);               // one line per episode
+bool     encounters_clear();
+
+// Raw slot stream for bulk download (see fring_stream_read)
+bool     encounters_stream_range(uint32_t& begin, uint32_t& end);   // false: ring busy, retry
+size_t   encounters_stream_read(uint32_t& pos, uint8_t* dst, size_t len);   // FRING_BUSY: retry
@@ -0,0 +1,325 @@
+#include "fdr.h"
+#include "flash_ring.h"
+#include "../app/state_store.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
+
+// ---- Page format (one FlashRing record) ----
+// [u32 t0_ms][u16 dt_nominal][u16 n_samples][u8 used][u8 flags][data...]
+// Each sample starts with a control byte:
+//   bit7=1 : run of ((b & 0x7F) + 1) samples identical to the previous one, nominal dt
+//   bit7=0 : field mask, followed by the present fields in this order:
+//            DT (varint ms), then zigzag-varint deltas of ALT, VS, SOG, TRK,
+//            then DISC (raw byte)
+// The first sample of a page is encoded against an all-zero state at t0,
+// so every page decodes on its own.
+static const uint16_t PAGE_PAYLOAD = 248;                  // FlashRing slot 256
+static const uint16_t PAGE_HDR     = 10;
+static const uint16_t PAGE_DATA    = PAGE_PAYLOAD - PAGE_HDR;
+static const uint16_t SAMPLE_MAX   = 1 + 5 + 5 + 3 + 3 + 3 + 1;
+
+enum : uint8_t { F_ALT=0x01, F_VS=0x02, F_SOG=0x04, F_TRK=0x08, F_DISC=0x10, F_DT=0x20, RUN=0x80 };
+enum : uint8_t { PG_FIRST_SINCE_BOOT = 0x01 };
+
+static const int32_t NA = -10000;   // quantized "unknown" for alt (m), sog and track (outside any real value)
+
+struct FdrPage {
+  uint32_t t0_ms;
+  uint16_t dt_nom;
+  uint16_t n;
+  uint8_t  used;
+  uint8_t  flags;
+  uint8_t  data[PAGE_DATA];
+};
+static_assert(sizeof(FdrPage) == PAGE_PAYLOAD, "page must fill one ring payload");
+
+// Quantized sample: alt 1 m, vs 0.1 m/s, sog 0.1 kt, track 0.1 deg
+struct QSample {
+  int32_t alt, vs, sog, trk;
+  uint8_t disc;                 // alarm:2 | state:3 | strobe level:2 | strobe on:1
+  bool operator==(const QSample& o) const {
+    return alt==o.alt && vs==o.vs && sog==o.sog && trk==o.trk && disc==o.disc;
+  }
+};
+
+// ---- Writer task plumbing: fixed pool of page buffers ----
+static const int POOL = 3;
+static FdrPage        pool[POOL];
+static QueueHandle_t  qFree = nullptr, qFull = nullptr;
+static SemaphoreHandle_t ringLock = nullptr;
+static FlashRing      ring;
+static bool           mounted = false;
+static uint32_t       dropped = 0;
+static std::atomic<uint32_t> queued{0};      // pages handed to the writer (control task)
+static std::atomic<uint32_t> committed{0};   // pages the writer has finished with
+
+// Flush requests from other tasks: the encoder below belongs to the control
+// task, so they only bump flushReq; fdr_tick() hands the page off, records
+// how many pages the writer must finish, then acks.
+static std::atomic<uint32_t> flushReq{0}, flushAck{0}, flushTarget{0};
+
+// ---- Encoder state (owned by the control task) ----
+static FdrPage* cur       = nullptr;
+static QSample  prev      = {};
+static uint32_t prevT     = 0;
+static uint8_t  runLen    = 0;       // pending identical samples not yet emitted
+static uint32_t nextDue   = 0;
+static bool     firstPage = true;
+
+static inline uint32_t zz(int32_t v){ return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t  unzz(uint32_t v){ return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static inline void put_varint(uint8_t*& p, uint32_t v){
+  while (v >= 0x80) { *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+  *p++ = (uint8_t)v;
+}
+static bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v){
+  v = 0;
+  for (int shift=0; shift<35 && p<end; shift+=7) {
+    uint8_t b = *p++;
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+static QSample quantize(const HaloState& st){
+  const Telemetry& tele = st.tele;
+  QSample q;
+  q.alt = isnan(tele.alt_m)     ? NA : (int32_t)lroundf(tele.alt_m);
+  q.vs  = (int32_t)lroundf(tele.vs_ms * 10.0f);
+  q.sog = isnan(tele.sog_kts)   ? NA : (int32_t)lroundf(tele.sog_kts * 10.0f);
+  q.trk = isnan(tele.track_deg) ? NA : (int32_t)lroundf(tele.track_deg * 10.0f);
+  uint8_t alarm = (uint8_t)constrain(st.alert.active ? st.alert.alarm : 0, 0, 3);
+  q.disc = (uint8_t)(alarm | ((st.state & 0x07) << 2) | ((st.strobe_level & 0x03) << 5)
+                     | (st.strobe_on ? 0x80 : 0));
+  return q;
+}
+
+static void writer_task(void*){
+  FdrPage* pg;
+  for (;;) {
+    if (xQueueReceive(qFull, &pg, portMAX_DELAY) != pdTRUE) continue;
+    xSemaphoreTake(ringLock, portMAX_DELAY);
+    if (!fring_append(ring, pg)) dropped++;
+    xSemaphoreGive(ringLock);
+    xQueueSend(qFree, &pg, 0);
+    committed.fetch_add(1, std::memory_order_release);
+  }
+}
+
+bool fdr_begin(){
+  mounted = fring_open(ring, "fdr", sizeof(FdrPage));
+  if (!mounted) return false;
+
+  qFree    = xQueueCreate(POOL, sizeof(FdrPage*));
+  qFull    = xQueueCreate(POOL, sizeof(FdrPage*));
+  ringLock = xSemaphoreCreateMutex();
+  for (int i=0; i<POOL; ++i) { FdrPage* p = &pool[i]; xQueueSend(qFree, &p, 0); }
+
+  xTaskCreatePinnedToCore(writer_task, "fdr_wr", 3072, nullptr, 1, nullptr, tskNO_AFFINITY);
+  Serial.printf("[FDR] recorder up (%lu pages stored)\n", (unsigned long)fring_count(ring));
+  return true;
+}
+
+static void emit_run(){
+  if (!cur || !runLen) return;
+  cur->data[cur->used++] = (uint8_t)(RUN | (runLen - 1));
+  runLen = 0;
+}
+
+static void hand_off(){
+  if (!cur) return;
+  emit_run();
+  if (cur->n) {
+    if (xQueueSend(qFull, &cur, 0) != pdTRUE) { dropped++; xQueueSend(qFree, &cur, 0); }
+    else queued.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    xQueueSend(qFree, &cur, 0);
+  }
+  cur = nullptr;
+}
+
+static bool open_page(uint32_t t, uint32_t dt_nom){
+  if (xQueueReceive(qFree, &cur, 0) != pdTRUE) { cur = nullptr; return false; }
+  cur->t0_ms  = t;
+  cur->dt_nom = (uint16_t)dt_nom;
+  cur->n      = 0;
+  cur->used   = 0;
+  cur->flags  = firstPage ? PG_FIRST_SINCE_BOOT : 0;
+  memset(cur->data, 0, sizeof(cur->data));
+  firstPage = false;
+  prev  = QSample{0,0,0,0,0};
+  prevT = t;
+  runLen = 0;
+  return true;
+}
+
+static void encode(const QSample& q, uint32_t t, uint32_t dt_nom){
+  if (cur && cur->used + SAMPLE_MAX + 1 > PAGE_DATA) hand_off();
+  if (cur && cur->dt_nom != dt_nom) hand_off();        // cadence changed: new page
+  if (!cur && !open_page(t, dt_nom)) { dropped++; return; }
+
+  const uint32_t dt = (cur->n == 0) ? 0 : (t - prevT);
+  const bool nominal = (cur->n == 0) || (dt == dt_nom);
+
+  if (cur->n && nominal && q == prev) {
+    if (++runLen == 128) emit_run();
+  } else {
+    emit_run();
+    uint8_t* p = &cur->data[cur->used];
+    uint8_t* m = p++;
+    uint8_t mask = 0;
+    if (!nominal)          { mask |= F_DT;   put_varint(p, dt); }
+    if (q.alt != prev.alt) { mask |= F_ALT;  put_varint(p, zz(q.alt - prev.alt)); }
+    if (q.vs  != prev.vs)  { mask |= F_VS;   put_varint(p, zz(q.vs  - prev.vs)); }
+    if (q.sog != prev.sog) { mask |= F_SOG;  put_varint(p, zz(q.sog - prev.sog)); }
+    if (q.trk != prev.trk) {
+      int32_t d = q.trk - prev.trk;                     // shortest way round the dial
+      if (q.trk >= 0 && prev.trk >= 0) { if (d > 1800) d -= 3600; else if (d < -1800) d += 3600; }
+      mask |= F_TRK; put_varint(p, zz(d));
+    }
+    if (q.disc != prev.disc) { mask |= F_DISC; *p++ = q.disc; }
+    *m = mask;
+    cur->used = (uint8_t)(p - cur->data);
+  }
+  cur->n++;
+  prev  = q;
+  prevT = t;
+}
+
+void fdr_tick(uint32_t now){
+  if (!mounted) return;
+  const uint32_t req = flushReq.load(std::memory_order_acquire);
+  if (req != flushAck.load(std::memory_order_relaxed)) {
+    hand_off();
+    flushTarget.store(queued.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    flushAck.store(req, std::memory_order_release);
+  }
+
+  static HaloState st;
+  static QSample   lastQ;
+  static uint32_t  seen = 0;
+  const bool airborne = (st.state == ST_FLYING || st.state == ST_ALERT || st.state == ST_LANDING);
+  const uint32_t period = airborne ? FDR_PERIOD_AIR_MS : FDR_PERIOD_GND_MS;
+
+  if (nextDue == 0) nextDue = now;
+  if ((int32_t)(now - nextDue) < 0) return;
+
+  // Timestamp on the schedule grid so steady sampling needs no dt bytes;
+  // re-anchor after a stall instead of emitting a burst.
+  const uint32_t t = nextDue;
+  nextDue += period;
+  if ((int32_t)(now - nextDue) >= 0) nextDue = now + period;
+
+  // Re-quantize only when a recorded field group changed; otherwise the repeat encodes as a run
+  if (state_read(st, seen) & (SM_TELE | SM_ALERT | SM_FSM)) lastQ = quantize(st);
+  encode(lastQ, t, period);
+}
+
+void fdr_flush(){
+  if (mounted) hand_off();
+}
+
+// Any task: have the control task hand off its partial page, then wait until
+// the writer has committed everything up to it. false on timeout.
+static bool flush_and_wait(uint32_t timeout_ms){
+  const uint32_t req = flushReq.fetch_add(1, std::memory_order_acq_rel) + 1;
+  const uint32_t t0 = millis();
+  while ((int32_t)(flushAck.load(std::memory_order_acquire) - req) < 0
+         || (int32_t)(committed.load(std::memory_order_acquire) - flushTarget.load(std::memory_order_relaxed)) < 0) {
+    if (millis() - t0 >= timeout_ms) return false;
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+  return true;
+}
+
+uint32_t fdr_pages(){ return mounted ? fring_count(ring) : 0; }
+uint32_t fdr_dropped_pages(){ return dropped; }
+
+// Bulk download runs on the control task: never wait behind an append/erase
+bool fdr_stream_range(uint32_t& begin, uint32_t& end){
+  begin = end = 0;
+  if (!mounted) return true;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return false;
+  begin = fring_stream_begin(ring);
+  end   = fring_stream_end(ring);
+  xSemaphoreGive(ringLock);
+  return true;
+}
+
+size_t fdr_stream_read(uint32_t& pos, uint8_t* dst, size_t len){
+  if (!mounted) return 0;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return FRING_BUSY;
+  size_t n = fring_stream_read(ring, pos, dst, len);
+  xSemaphoreGive(ringLock);
+  return n;
+}
+
+// ---- Export ----
+static void export_page(Print& out, const FdrPage& pg, uint32_t seq){
+  out.printf("# page %lu t0=%lu dt=%u n=%u%s\n", (unsigned long)seq, (unsigned long)pg.t0_ms,
+             (unsigned)pg.dt_nom, (unsigned)pg.n, (pg.flags & PG_FIRST_SINCE_BOOT) ? " boot" : "");
+
+  const uint8_t* p   = pg.data;
+  const uint8_t* end = pg.data + min<uint16_t>(pg.used, PAGE_DATA);
+  QSample  s = {0,0,0,0,0};
+  uint32_t t = pg.t0_ms;
+
+  auto row = [&](){
+    const uint8_t alarm = s.disc & 0x03, st = (s.disc >> 2) & 0x07, lvl = (s.disc >> 5) & 0x03;
+    char alt[12], sog[12], trk[12];
+    if (s.alt == NA) strcpy(alt, ""); else snprintf(alt, sizeof(alt), "%ld", (long)s.alt);
+    if (s.sog == NA) strcpy(sog, ""); else snprintf(sog, sizeof(sog), "%.1f", s.sog / 10.0f);
+    if (s.trk == NA) strcpy(trk, ""); else snprintf(trk, sizeof(trk), "%.1f", s.trk / 10.0f);
+    out.printf("%lu,%s,%.1f,%s,%s,%u,%u,%u,%u\n", (unsigned long)t, alt, s.vs / 10.0f,
+               sog, trk, alarm, st, lvl, (s.disc & 0x80) ? 1u : 0u);
+  };
+
+  for (uint16_t i=0; i<pg.n && p<end; ) {
+    uint8_t c = *p++;
+    if (c & RUN) {
+      for (uint16_t k=0; k<(uint16_t)((c & 0x7F) + 1) && i<pg.n; ++k, ++i) { t += pg.dt_nom; row(); }
+      continue;
+    }
+    uint32_t v;
+    if (c & F_DT) { if (!get_varint(p, end, v)) break; t += v; }
+    else if (i)   { t += pg.dt_nom; }
+    if (c & F_ALT) { if (!get_varint(p, end, v)) break; s.alt += unzz(v); }
+    if (c & F_VS)  { if (!get_varint(p, end, v)) break; s.vs  += unzz(v); }
+    if (c & F_SOG) { if (!get_varint(p, end, v)) break; s.sog += unzz(v); }
+    if (c & F_TRK) {
+      if (!get_varint(p, end, v)) break;
+      s.trk += unzz(v);
+      if (s.trk >= 3600) s.trk -= 3600; else if (s.trk < 0 && s.trk != NA) s.trk += 3600;
+    }
+    if (c & F_DISC) { if (p >= end) break; s.disc = *p++; }
+    row(); ++i;
+  }
+}
+
+void fdr_export(Print& out){
+  if (!mounted) { out.println("[FDR] not mounted"); return; }
+  if (!flush_and_wait(1000)) out.println("[FDR] partial page not committed (recorder busy)");
+
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  const uint32_t n = fring_count(ring);
+  xSemaphoreGive(ringLock);
+
+  out.printf("[FDR] %lu pages, %lu dropped\n", (unsigned long)n, (unsigned long)dropped);
+  out.println("t_ms,alt_m,vs_ms,sog_kts,trk_deg,alarm,state,strobe_lvl,strobe_on");
+  for (uint32_t i=0; i<n; ++i) {
+    FdrPage pg; uint32_t seq = 0;
+    xSemaphoreTake(ringLock, portMAX_DELAY);
+    bool ok = fring_read(ring, i, &pg, &seq);
+    xSemaphoreGive(ringLock);
+    if (ok) export_page(out, pg, seq);
+    else    out.printf("# page %lu <corrupt>\n", (unsigned long)i);
+    if ((i & 7) == 7) yield();
+  }
+  out.println("[FDR] end");
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <Arduino.h>
+
+// Flight data recorder: 5 Hz in the air / 1 Hz on the ground.
+// Samples are delta/varint-encoded into 256-byte pages in RAM; full pages are
+// handed to a low-priority task that appends them to the "fdr" flash ring, so
+// the caller never waits on flash.
+
+static constexpr uint32_t FDR_PERIOD_AIR_MS = 200;
+static constexpr uint32_t FDR_PERIOD_GND_MS = 1000;
+
+bool     fdr_begin();                 // mount partition + start writer task
+void     fdr_tick(uint32_t now);      // call every loop; samples on schedule
+void     fdr_flush();                 // control task: hand the partial page to the writer (e.g. at LANDED)
+void     fdr_export(Print& out);      // any task: flush via the control task, then stream all pages as CSV
+uint32_t fdr_pages();
+uint32_t fdr_dropped_pages();
+
+// Raw page stream for bulk download (see fring_stream_read); safe against the writer task
+bool     fdr_stream_range(uint32_t& begin, uint32_t& end);   // false: ring busy, retry
+size_t   fdr_stream_read(uint32_t& pos, uint8_t* dst, size_t len);   // FRING_BUSY: retry
@@ -0,0 +1,175 @@
+#include "flash_ring.h"
+
+static const uint32_t SECTOR     = 4096;
+static const uint16_t MAX_SLOT   = 256;     // one flash page; keeps the staging buffer on the stack
+static const uint16_t MARKER     = 0xA55A;
+static const uint32_t SEQ_ERASED = 0xFFFFFFFFu;
+
+struct SlotHdr {
+  uint32_t seq;
+  uint16_t crc;
+  uint16_t marker;
+};
+static_assert(sizeof(SlotHdr) == FRING_HDR_BYTES, "slot header must stay 8 bytes");
+
+static uint16_t crc16_ccitt(const uint8_t* p, size_t n){
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (int i=0; i<8; ++i) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static inline uint32_t slot_addr(const FlashRing& r, uint32_t slot){ return slot * r.slot_size; }
+
+static bool read_hdr(const FlashRing& r, uint32_t slot, SlotHdr& h){
+  return esp_partition_read(r.part, slot_addr(r, slot), &h, sizeof(h)) == ESP_OK;
+}
+static inline bool hdr_used(const SlotHdr& h){ return h.seq != SEQ_ERASED && h.marker == MARKER; }
+static inline bool hdr_blank(const SlotHdr& h){ return h.seq == SEQ_ERASED && h.marker == 0xFFFF; }
+
+bool fring_open(FlashRing& r, const char* label, uint16_t payload_bytes){
+  r = FlashRing{};
+  r.part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (!r.part) {
+    Serial.printf("[RING] partition '%s' not found\n", label);
+    return false;
+  }
+
+  uint16_t need = payload_bytes + FRING_HDR_BYTES;
+  uint16_t slot = 16;
+  while (slot < need) slot <<= 1;
+  if (slot > MAX_SLOT) return false;
+
+  r.slot_size  = slot;
+  r.payload    = payload_bytes;
+  r.per_sector = SECTOR / slot;
+  r.sectors    = r.part->size / SECTOR;
+  r.capacity   = r.per_sector * r.sectors;
+  if (r.sectors < 2) return false;
+
+  // Newest sector = highest sequence number in its first slot.
+  int32_t  newest = -1;
+  uint32_t newestSeq = 0;
+  for (uint32_t s=0; s<r.sectors; ++s) {
+    SlotHdr h;
+    if (!read_hdr(r, s * r.per_sector, h)) return false;
+    if (hdr_used(h) && (newest < 0 || h.seq > newestSeq)) { newest = (int32_t)s; newestSeq = h.seq; }
+  }
+
+  if (newest < 0) {
+    SlotHdr h;
+    read_hdr(r, 0, h);
+    if (!hdr_blank(h)) esp_partition_erase_range(r.part, 0, SECTOR);
+    Serial.printf("[RING] %s: empty (%lu slots x %uB)\n", label,
+                  (unsigned long)r.capacity, (unsigned)r.slot_size);
+    return true;
+  }
+
+  // Written slots form a prefix of the newest sector: binary search its end.
+  const uint32_t base = (uint32_t)newest * r.per_sector;
+  uint32_t lo = 1, hi = r.per_sector;        // first blank slot lies in [lo, hi]
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    SlotHdr h; read_hdr(r, base + mid, h);
+    if (hdr_used(h)) lo = mid + 1; else hi = mid;
+  }
+  SlotHdr last; read_hdr(r, base + lo - 1, last);
+  r.head     = (base + lo) % r.capacity;
+  r.next_seq = last.seq + 1;
+
+  // Oldest sector = first used sector after the newest one, going forward.
+  uint32_t tailSector = (uint32_t)newest;
+  for (uint32_t i=1; i<r.sectors; ++i) {
+    uint32_t s = ((uint32_t)newest + i) % r.sectors;
+    SlotHdr h; read_hdr(r, s * r.per_sector, h);
+    if (hdr_used(h)) { tailSector = s; break; }
+  }
+  SlotHdr first; read_hdr(r, tailSector * r.per_sector, first);
+  r.tail  = tailSector * r.per_sector;
+  r.count = r.next_seq - first.seq;
+
+  Serial.printf("[RING] %s: %lu records, next seq %lu\n", label,
+                (unsigned long)r.count, (unsigned long)r.next_seq);
+  return true;
+}
+
+bool fring_append(FlashRing& r, const void* rec){
+  if (!r.part) return false;
+
+  // Entering a sector: recycle it (dropping the oldest records if we wrapped).
+  if ((r.head % r.per_sector) == 0) {
+    const uint32_t sector = r.head / r.per_sector;
+    if (r.count && (r.tail / r.per_sector) == sector) {
+      r.count -= min(r.count, r.per_sector);
+      r.tail   = (r.tail + r.per_sector) % r.capacity;
+    }
+    if (esp_partition_erase_range(r.part, sector * SECTOR, SECTOR) != ESP_OK) return false;
+  }
+
+  uint8_t buf[MAX_SLOT];
+  SlotHdr h;
+  h.seq    = r.next_seq;
+  h.crc    = crc16_ccitt((const uint8_t*)rec, r.payload);
+  h.marker = MARKER;
+  memcpy(buf, &h, sizeof(h));
+  memcpy(buf + sizeof(h), rec, r.payload);
+
+  if (esp_partition_write(r.part, slot_addr(r, r.head), buf, sizeof(h) + r.payload) != ESP_OK) return false;
+
+  if (r.count == 0) r.tail = r.head;
+  r.head = (r.head + 1) % r.capacity;
+  r.count++;
+  r.next_seq++;
+  return true;
+}
+
+bool fring_read(const FlashRing& r, uint32_t index, void* out, uint32_t* seq){
+  if (!r.part || index >= r.count) return false;
+  const uint32_t slot = (r.tail + index) % r.capacity;
+
+  uint8_t buf[MAX_SLOT];
+  if (esp_partition_read(r.part, slot_addr(r, slot), buf, FRING_HDR_BYTES + r.payload) != ESP_OK) return false;
+
+  SlotHdr h; memcpy(&h, buf, sizeof(h));
+  if (!hdr_used(h)) return false;
+  if (crc16_ccitt(buf + sizeof(h), r.payload) != h.crc) return false;
+
+  memcpy(out, buf + sizeof(h), r.payload);
+  if (seq) *seq = h.seq;
+  return true;
+}
+
+uint32_t fring_count(const FlashRing& r){ return r.count; }
+
+bool fring_clear(FlashRing& r){
+  if (!r.part) return false;
+  if (esp_partition_erase_range(r.part, 0, r.sectors * SECTOR) != ESP_OK) return false;
+  r.head = r.tail = r.count = 0;
+  r.next_seq = 1;
+  return true;
+}
+
+uint32_t fring_stream_begin(const FlashRing& r){ return (r.next_seq - r.count - 1) * r.slot_size; }
+uint32_t fring_stream_end(const FlashRing& r){ return (r.next_seq - 1) * r.slot_size; }
+
+size_t fring_stream_read(const FlashRing& r, uint32_t& pos, uint8_t* dst, size_t len){
+  if (!r.part) return 0;
+  const uint32_t begin = fring_stream_begin(r), end = fring_stream_end(r);
+  if (pos < begin) pos = begin;
+  if (pos >= end) return 0;
+
+  size_t   want = min<size_t>(len, end - pos);
+  size_t   got  = 0;
+  uint32_t rel  = pos - begin;                       // bytes past the oldest slot
+  while (got < want) {
+    const uint32_t slot   = (r.tail + rel / r.slot_size) % r.capacity;
+    const uint32_t phys   = slot * r.slot_size + rel % r.slot_size;
+    const uint32_t toWrap = r.capacity * r.slot_size - phys;   // contiguous until partition end
+    const size_t   run    = min<size_t>(want - got, toWrap);
+    if (esp_partition_read(r.part, phys, dst + got, run) != ESP_OK) break;
+    got += run; rel += run;
+  }
+  return got;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_partition.h>
+
+// Append-only ring of fixed-size records in a raw data partition.
+//
+// Slot layout: [u32 seq][u16 crc16(payload)][u16 marker][payload...]
+// Erased flash reads 0xFF, so an erased slot has seq == 0xFFFFFFFF.
+// Slots are filled strictly in order and a sector is erased only when the
+// write head enters it, so wear spreads across the whole partition and the
+// oldest sector is always the one recycled.
+//
+// open() reads one header per sector plus a binary search inside the newest
+// sector; append and indexed reads are O(1) flash operations.
+struct FlashRing {
+  const esp_partition_t* part = nullptr;
+  uint16_t slot_size   = 0;   // bytes per slot (power of two, <= 4096)
+  uint16_t payload     = 0;   // user bytes per slot (slot_size - header)
+  uint32_t per_sector  = 0;   // slots per 4 KB sector
+  uint32_t sectors     = 0;
+  uint32_t capacity    = 0;   // slots in partition
+  uint32_t head        = 0;   // next slot to write
+  uint32_t tail        = 0;   // oldest valid slot
+  uint32_t count       = 0;   // valid records
+  uint32_t next_seq    = 1;
+};
+
+static constexpr uint16_t FRING_HDR_BYTES = 8;
+
+// label: partition label from partitions.csv; payload_bytes: user record size.
+bool     fring_open(FlashRing& r, const char* label, uint16_t payload_bytes);
+bool     fring_append(FlashRing& r, const void* rec);
+bool     fring_read(const FlashRing& r, uint32_t index, void* out, uint32_t* seq = nullptr); // 0 = oldest
+uint32_t fring_count(const FlashRing& r);
+bool     fring_clear(FlashRing& r);
+
+// Raw slot stream for bulk export. Positions are absolute: record seq s occupies
+// [(s-1)*slot_size, s*slot_size), so a saved position stays valid while the ring
+// moves. Reads copy straight from flash into dst (headers included, so the
+// reader can check seq/crc). A position in recycled records is moved up to begin.
+uint32_t fring_stream_begin(const FlashRing& r);
+uint32_t fring_stream_end(const FlashRing& r);
+size_t   fring_stream_read(const FlashRing& r, uint32_t& pos, uint8_t* dst, size_t len);
+
+// Returned by the per-partition *_stream_read() wrappers when a writer holds the
+// ring (possibly through a sector erase); nothing was read, try again later.
+static constexpr size_t FRING_BUSY = (size_t)-1;
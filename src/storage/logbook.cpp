@@ -0,0 +1,96 @@
+#include "logbook.h"
+#include "flash_ring.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <time.h>
+
+static FlashRing ring;
+static bool      mounted = false;
+static SemaphoreHandle_t ringLock = nullptr;  // loop() appends vs. BLE bulk reads on the control task
+
+bool logbook_begin(){
+  if (!ringLock) ringLock = xSemaphoreCreateMutex();
+  mounted = fring_open(ring, "logbook", sizeof(LogbookEntry));
+  return mounted;
+}
+
+bool logbook_append(const LogbookEntry& e){
+  if (!mounted) return false;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  bool ok = fring_append(ring, &e);
+  const uint32_t no = ring.next_seq - 1;
+  xSemaphoreGive(ringLock);
+  Serial.printf("[LOG] flight #%lu %s (%lus, maxAGL %dft)\n",
+                (unsigned long)no, ok ? "logged" : "FAILED",
+                (unsigned long)e.duration_s, (int)e.max_agl_ft);
+  return ok;
+}
+
+uint32_t logbook_count(){
+  if (!mounted) return 0;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  uint32_t n = fring_count(ring);
+  xSemaphoreGive(ringLock);
+  return n;
+}
+
+bool logbook_read(uint32_t index, LogbookEntry& out, uint32_t* flight_no){
+  if (!mounted) return false;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  bool ok = fring_read(ring, index, &out, flight_no);
+  xSemaphoreGive(ringLock);
+  return ok;
+}
+
+static void fmt_utc(char* buf, size_t n, uint32_t t){
+  if (!t) { snprintf(buf, n, "----------- --:--"); return; }
+  time_t tt = (time_t)t;
+  struct tm tmv; gmtime_r(&tt, &tmv);
+  strftime(buf, n, "%Y-%m-%d %H:%M", &tmv);
+}
+
+void logbook_dump(Print& out){
+  uint32_t n = logbook_count();
+  out.printf("[LOG] %lu flights\n", (unsigned long)n);
+  for (uint32_t i=0; i<n; ++i) {
+    LogbookEntry e; uint32_t no = 0;
+    if (!logbook_read(i, e, &no)) { out.printf("#%lu <corrupt>\n", (unsigned long)i); continue; }
+    char t0[20], t1[20];
+    fmt_utc(t0, sizeof(t0), e.takeoff_utc);
+    fmt_utc(t1, sizeof(t1), e.landing_utc);
+    char dmin[8];
+    if (e.min_dist_m == 0xFFFF) snprintf(dmin, sizeof(dmin), "--");
+    else                        snprintf(dmin, sizeof(dmin), "%um", (unsigned)e.min_dist_m);
+    out.printf("#%lu %s -> %s  %lu:%02lu  maxAGL %dft  alerts %u/%u/%u  min %s\n",
+               (unsigned long)no, t0, t1,
+               (unsigned long)(e.duration_s / 3600u), (unsigned long)((e.duration_s % 3600u) / 60u),
+               (int)e.max_agl_ft, e.alerts[0], e.alerts[1], e.alerts[2], dmin);
+  }
+}
+
+bool logbook_clear(){
+  if (!mounted) return false;
+  xSemaphoreTake(ringLock, portMAX_DELAY);
+  bool ok = fring_clear(ring);
+  xSemaphoreGive(ringLock);
+  return ok;
+}
+
+// Bulk download runs on the control task: never wait behind an append/erase
+bool logbook_stream_range(uint32_t& begin, uint32_t& end){
+  begin = end = 0;
+  if (!mounted) return true;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return false;
+  begin = fring_stream_begin(ring);
+  end   = fring_stream_end(ring);
+  xSemaphoreGive(ringLock);
+  return true;
+}
+
+size_t logbook_stream_read(uint32_t& pos, uint8_t* dst, size_t len){
+  if (!mounted) return 0;
+  if (xSemaphoreTake(ringLock, 0) != pdTRUE) return FRING_BUSY;
+  size_t n = fring_stream_read(ring, pos, dst, len);
+  xSemaphoreGive(ringLock);
+  return n;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+
+// One fixed-size record per flight, appended at LANDED by app_fsm_service()
+// in loop(); the control task only queues it.
+struct LogbookEntry {
+  uint32_t takeoff_utc  = 0;       // unix seconds, 0 = unknown
+  uint32_t landing_utc  = 0;       // unix seconds, 0 = unknown
+  uint32_t duration_s   = 0;
+  int16_t  max_agl_ft   = 0;
+  uint16_t min_dist_m   = 0xFFFF;  // closest traffic, 0xFFFF = none seen
+  uint16_t alerts[3]    = {0,0,0}; // alert count per level L1..L3
+  uint16_t reserved     = 0;
+};
+static_assert(sizeof(LogbookEntry) == 24, "logbook record layout is persisted");
+
+bool     logbook_begin();                          // mount the "logbook" partition
+bool     logbook_append(const LogbookEntry& e);
+uint32_t logbook_count();
+bool     logbook_read(uint32_t index, LogbookEntry& out, uint32_t* flight_no = nullptr); // 0 = oldest
+void     logbook_dump(Print& out);                 // one line per flight
+bool     logbook_clear();
+
+// Raw slot stream for bulk download (see fring_stream_read)
+bool     logbook_stream_range(uint32_t& begin, uint32_t& end);   // false: ring busy, retry
+size_t   logbook_stream_read(uint32_t& pos, uint8_t* dst, size_t len);   // FRING_BUSY: retry
@@ -41,7 +41,7 @@ static void send_gga(int sats){
 static void send_pflaa(int alarm, float rn, float re, float rv){
   char line[128];
   snprintf(line, sizeof(line),
-    "$PFLAA,%d,%.0f,%.0f,%.0f,1234,0,0,0,0,0*00\n", alarm, rn, re, rv);
+    "$PFLAA,%d,%.0f,%.0f,%.0f,2,DD1234,0,0,0,0,1*00\n", alarm, rn, re, rv);
   nav_inject_nmea(line);
 }
 
@@ -0,0 +1,105 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Fixed-point angles and trig from compile-time tables.
+//
+// Angles are binary angle measurement (BAM): a uint16_t where 65536 = 360°,
+// so wrap-around is free and differences never need normalising. Sine and
+// cosine are Q15 (32767 = 1.0). The tables below are generated by constexpr
+// series at compile time and land in flash (.rodata); lookups interpolate
+// with integer arithmetic only, so results are bit-exact on the target and
+// on a host compiler.
+typedef uint16_t bam16_t;
+
+static constexpr bam16_t BAM_90  = 0x4000;
+static constexpr bam16_t BAM_180 = 0x8000;
+static constexpr int16_t Q15_ONE = 32767;
+
+// ---- Compile-time generators (C++11 constexpr: single-expression recursion) ----
+namespace fixed_trig_detail {
+constexpr double kPi = 3.14159265358979323846;
+
+// sin(x) = x - x^3/3! + ...; x in [0, pi/2], 11 terms is far below Q15 resolution
+constexpr double sin_series(double x2, double term, int k, double acc){
+  return k > 10 ? acc : sin_series(x2, -term * x2 / ((2*k + 2) * (2*k + 3)), k + 1, acc + term);
+}
+constexpr double ct_sin(double x){ return sin_series(x * x, x, 0, 0.0); }
+
+// atan(t) = t - t^3/3 + ...; arguments above tan(22.5°) fold through pi/4 + atan((t-1)/(t+1))
+constexpr double atan_series(double x2, double pw, int k, double acc){
+  return k > 30 ? acc : atan_series(x2, pw * x2, k + 1, acc + ((k & 1) ? -pw : pw) / (2*k + 1));
+}
+constexpr double ct_atan_small(double t){ return atan_series(t * t, t, 0, 0.0); }
+constexpr double ct_atan(double t){
+  return t > 0.41421356237 ? kPi / 4 + ct_atan_small((t - 1) / (t + 1)) : ct_atan_small(t);
+}
+
+constexpr int16_t  sin_entry(int i){ return (int16_t)(ct_sin(i * (kPi / 2) / 256) * Q15_ONE + 0.5); }
+constexpr uint16_t atan_entry(int i){ return (uint16_t)(ct_atan(i / 256.0) * (65536.0 / (2 * kPi)) + 0.5); }
+
+template <int... I> struct IdxSeq {};
+template <int N, int... I> struct MakeIdx : MakeIdx<N - 1, N - 1, I...> {};
+template <int... I> struct MakeIdx<0, I...> { typedef IdxSeq<I...> type; };
+
+template <typename Seq> struct Tables;
+template <int... I> struct Tables<IdxSeq<I...>> {
+  static constexpr int16_t  sin_q15[sizeof...(I)]  = { sin_entry(I)... };    // sin(i/256 * 90°)
+  static constexpr uint16_t atan_bam[sizeof...(I)] = { atan_entry(I)... };   // atan(i/256), BAM
+};
+template <int... I> constexpr int16_t  Tables<IdxSeq<I...>>::sin_q15[sizeof...(I)];
+template <int... I> constexpr uint16_t Tables<IdxSeq<I...>>::atan_bam[sizeof...(I)];
+}  // namespace fixed_trig_detail
+
+// 257 entries each: quarter wave / first octant, endpoints included
+typedef fixed_trig_detail::Tables<fixed_trig_detail::MakeIdx<257>::type> TrigTables;
+
+static_assert(TrigTables::sin_q15[0] == 0 && TrigTables::sin_q15[256] == Q15_ONE, "sine table endpoints");
+static_assert(TrigTables::sin_q15[128] == 23170, "sin(45°) in Q15");
+static_assert(TrigTables::atan_bam[0] == 0 && TrigTables::atan_bam[256] == 8192, "atan(1) = 45° = 8192 BAM");
+
+// ---- Conversions ----
+inline bam16_t bam_from_deg(float deg){ return (bam16_t)(int32_t)lroundf(deg * (65536.0f / 360.0f)); }
+inline float   bam_to_deg(bam16_t a){ return (float)a * (360.0f / 65536.0f); }
+
+// Q15 -> integer, rounded; and a rounded Q15 product (scale a length by a sine/cosine)
+inline int32_t q15_round(int32_t v){ return (v + (1 << 14)) >> 15; }
+inline int32_t q15_mul(int32_t v, int16_t q){ return q15_round(v * q); }
+
+// ---- Lookups ----
+inline int16_t isin(bam16_t a){
+  uint16_t r = a & 0x3FFF;                    // position inside the quadrant
+  if (a & 0x4000) r = 0x4000 - r;             // 2nd/4th quadrant: mirror (r may reach 0x4000)
+  const uint16_t i = r >> 6, f = r & 63;
+  int32_t v = TrigTables::sin_q15[i];
+  if (f) v += ((TrigTables::sin_q15[i + 1] - v) * f + 32) >> 6;
+  return (int16_t)((a & 0x8000) ? -v : v);
+}
+inline int16_t icos(bam16_t a){ return isin((bam16_t)(a + BAM_90)); }
+
+// Angle of (x, y) measured from +x towards +y. For a compass bearing pass
+// (east, north) as (y, x): iatan2(relE, relN) is 0 at north, 90° at east.
+inline bam16_t iatan2(int32_t y, int32_t x){
+  if (!x && !y) return 0;
+  uint32_t ax = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+  uint32_t ay = y < 0 ? 0u - (uint32_t)y : (uint32_t)y;
+  const bool steep = ay > ax;
+  uint32_t num = steep ? ax : ay, den = steep ? ay : ax;
+  if (den >= 0x8000u) { const int s = 17 - __builtin_clz(den); num >>= s; den >>= s; }   // keep num<<16 in 32 bits
+  const uint32_t r = (num << 16) / den;       // tan within the octant, 0..65536
+  const uint32_t i = r >> 8, f = r & 0xFF;
+  uint32_t a = TrigTables::atan_bam[i];
+  if (f) a += ((TrigTables::atan_bam[i + 1] - a) * f + 128) >> 8;
+  if (steep) a = BAM_90 - a;
+  if (x < 0) a = BAM_180 - a;
+  if (y < 0) a = 0x10000u - a;
+  return (bam16_t)a;
+}
+
+// 1..12 o'clock for a bearing relative to own heading. Sector k covers
+// [k*30° - 15°, k*30° + 15°): floor((rel/15° + 1) / 2) mod 12, with half a
+// BAM of bias so a boundary that rounded just below (e.g. 75°) counts upward.
+inline uint8_t clock_sector(bam16_t rel){
+  const uint8_t s = (uint8_t)((((uint32_t)rel * 24u + 65536u + 12u) >> 17) % 12u);
+  return s ? s : 12;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// Integer-to-text for the render paths, without snprintf/dtostrf (no format
+// parsing, no float, no locale). Every call writes at `out`, NUL-terminates,
+// and returns the characters written so calls chain:
+//   char b[12], *p = b; p += fmt_i32(p, kts); p += fmt_str(p, "kts");
+
+// Unsigned, left-padded with '0' to at least `width` digits ("%0*u")
+inline uint8_t fmt_u32(char* out, uint32_t v, uint8_t width = 1){
+  char tmp[10]; uint8_t n = 0;
+  do { tmp[n++] = (char)('0' + v % 10u); v /= 10u; } while (v);
+  while (n < width && n < sizeof(tmp)) tmp[n++] = '0';
+  for (uint8_t i = 0; i < n; ++i) out[i] = tmp[n - 1 - i];
+  out[n] = '\0';
+  return n;
+}
+
+// Signed ("%d")
+inline uint8_t fmt_i32(char* out, int32_t v){
+  if (v >= 0) return fmt_u32(out, (uint32_t)v);
+  out[0] = '-';
+  return (uint8_t)(1 + fmt_u32(out + 1, 0u - (uint32_t)v));
+}
+
+// Fixed point: v counts units of 10^-decimals, e.g. (123, 1) -> "12.3", (-5, 1) -> "-0.5"
+inline uint8_t fmt_fixed(char* out, int32_t v, uint8_t decimals){
+  uint32_t scale = 1;
+  for (uint8_t i = 0; i < decimals; ++i) scale *= 10u;
+  uint8_t n = 0;
+  if (v < 0) out[n++] = '-';
+  const uint32_t a = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+  n += fmt_u32(out + n, a / scale);
+  if (decimals) { out[n++] = '.'; n += fmt_u32(out + n, a % scale, decimals); }
+  return n;
+}
+
+// Literal suffix/prefix
+inline uint8_t fmt_str(char* out, const char* s){
+  uint8_t n = 0;
+  while (s[n]) { out[n] = s[n]; ++n; }
+  out[n] = '\0';
+  return n;
+}
@@ -0,0 +1,98 @@
+#include "hlog.h"
+#include "mpsc_ring.h"
+#include "../app/rtos_cfg.h"
+#include <freertos/task.h>
+
+struct HlogRec {
+  uint32_t    t_ms;
+  const char* fmt;
+  uint8_t     level;
+  uint8_t     n;
+  uint32_t    a[HLOG_MAX_ARGS];
+};
+
+static MpscRing<HlogRec, LOG_RING> ring;
+static std::atomic<uint32_t>       dropped{0};
+static std::atomic<bool>           muted{false};
+
+void hlog_push(uint8_t level, const char* fmt, const uint32_t* args, uint8_t n){
+  HlogRec r;
+  r.t_ms  = millis();
+  r.fmt   = fmt;
+  r.level = level;
+  r.n     = n;
+  memcpy(r.a, args, n * sizeof(uint32_t));
+  if (!ring.push(r)) dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t hlog_dropped(){ return dropped.load(std::memory_order_relaxed); }
+
+void hlog_set_muted(bool on){ muted.store(on, std::memory_order_relaxed); }
+
+// Re-expand a record: literal text is copied, each conversion is rendered by
+// snprintf with its own spec and the stored word cast back to the right type.
+static size_t format_rec(const HlogRec& r, char* out, size_t cap){
+  size_t   o = 0;
+  uint8_t  ai = 0;
+  const char* p = r.fmt;
+  while (*p && o + 1 < cap) {
+    if (*p != '%') { out[o++] = *p++; continue; }
+    if (p[1] == '%') { out[o++] = '%'; p += 2; continue; }
+
+    char spec[16]; size_t s = 0;
+    spec[s++] = *p++;
+    while (*p && !strchr("diouxXcsfFeEgGp", *p) && s < sizeof(spec) - 2) spec[s++] = *p++;
+    if (!*p) break;
+    const char conv = *p++;
+    spec[s++] = conv; spec[s] = 0;
+
+    const uint32_t w = (ai < r.n) ? r.a[ai++] : 0;
+    int k;
+    switch (conv) {
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+        float f; memcpy(&f, &w, 4);
+        k = snprintf(out + o, cap - o, spec, (double)f);
+      } break;
+      case 's': k = snprintf(out + o, cap - o, spec, w ? (const char*)(uintptr_t)w : "(null)"); break;
+      case 'p': k = snprintf(out + o, cap - o, spec, (void*)(uintptr_t)w); break;
+      case 'd': case 'i': case 'c':
+        k = strchr(spec, 'l') ? snprintf(out + o, cap - o, spec, (long)(int32_t)w)
+                              : snprintf(out + o, cap - o, spec, (int)(int32_t)w);
+        break;
+      default:
+        k = strchr(spec, 'l') ? snprintf(out + o, cap - o, spec, (unsigned long)w)
+                              : snprintf(out + o, cap - o, spec, (unsigned)w);
+        break;
+    }
+    if (k < 0) break;
+    o = min(o + (size_t)k, cap - 1);
+  }
+  out[o] = 0;
+  return o;
+}
+
+static void log_task(void*){
+  static char line[192];
+  uint32_t reported = 0;
+  for(;;){
+    HlogRec r;
+    while (ring.pop(r)) {
+      if (muted.load(std::memory_order_relaxed)) continue;
+      size_t n = format_rec(r, line, sizeof(line));
+      Serial.write((const uint8_t*)line, n);
+    }
+    const uint32_t d = dropped.load(std::memory_order_relaxed);
+    if (d != reported && !muted.load(std::memory_order_relaxed)) {
+      Serial.printf("[LOG] %lu record(s) dropped\n", (unsigned long)(d - reported));
+      reported = d;
+    }
+    vTaskDelay(pdMS_TO_TICKS(LOG_PERIOD_MS));
+  }
+}
+
+void hlog_begin(){
+  static bool started = false;
+  if (started) return;
+  started = true;
+  xTaskCreatePinnedToCore(log_task, "log", STACK_LOG, nullptr, PRIO_LOG, nullptr, CORE_AUX);
+}
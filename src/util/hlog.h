@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+
+// Deferred logging for hot paths. A call stores the format pointer and up to
+// HLOG_MAX_ARGS raw 32-bit arguments in a lock-free ring; no formatting and no
+// Serial I/O happens in the caller. A low-priority task formats and prints.
+//
+// Rules: the format must be a string literal, and %s arguments must point to
+// static strings (only the pointer is kept). float/double args are stored as
+// float. Full ring: the record is dropped and counted.
+//
+// Levels are compile-time (-D HALO_LOG_LEVEL=n); calls above the level compile
+// to nothing and their arguments are not evaluated.
+#define HLOG_LEVEL_NONE  0
+#define HLOG_LEVEL_ERROR 1
+#define HLOG_LEVEL_WARN  2
+#define HLOG_LEVEL_INFO  3
+#define HLOG_LEVEL_DEBUG 4
+
+#ifndef HALO_LOG_LEVEL
+#define HALO_LOG_LEVEL HLOG_LEVEL_INFO
+#endif
+
+static constexpr uint8_t HLOG_MAX_ARGS = 6;
+
+void hlog_begin();                                   // start the drain task
+void hlog_push(uint8_t level, const char* fmt, const uint32_t* args, uint8_t n);
+uint32_t hlog_dropped();
+// While muted the drain task discards records instead of printing them (the
+// USB link is carrying binary frames, app/data_port.h)
+void hlog_set_muted(bool on);
+
+// Argument capture: everything becomes one 32-bit word
+static inline uint32_t hlog_word(float v){ uint32_t w; memcpy(&w, &v, 4); return w; }
+static inline uint32_t hlog_word(double v){ return hlog_word((float)v); }
+static inline uint32_t hlog_word(const char* s){ return (uint32_t)(uintptr_t)s; }
+static inline uint32_t hlog_word(const void* p){ return (uint32_t)(uintptr_t)p; }
+static inline uint32_t hlog_word(bool v){ return v ? 1u : 0u; }
+static inline uint32_t hlog_word(char v){ return (uint32_t)(int32_t)v; }
+static inline uint32_t hlog_word(int v){ return (uint32_t)v; }
+static inline uint32_t hlog_word(unsigned v){ return (uint32_t)v; }
+static inline uint32_t hlog_word(long v){ return (uint32_t)v; }
+static inline uint32_t hlog_word(unsigned long v){ return (uint32_t)v; }
+static inline uint32_t hlog_word(int8_t v){ return (uint32_t)(int32_t)v; }
+static inline uint32_t hlog_word(uint8_t v){ return v; }
+static inline uint32_t hlog_word(int16_t v){ return (uint32_t)(int32_t)v; }
+static inline uint32_t hlog_word(uint16_t v){ return v; }
+
+template <typename... A>
+static inline void hlog_emit(uint8_t level, const char* fmt, A... args){
+  static_assert(sizeof...(A) <= HLOG_MAX_ARGS, "too many hlog arguments");
+  const uint32_t w[] = { 0u, hlog_word(args)... };   // leading 0 avoids a zero-length array
+  hlog_push(level, fmt, w + 1, (uint8_t)sizeof...(A));
+}
+
+// "" fmt only compiles with a string literal
+#if HALO_LOG_LEVEL >= HLOG_LEVEL_ERROR
+#define HLOGE(fmt, ...) hlog_emit(HLOG_LEVEL_ERROR, "" fmt, ##__VA_ARGS__)
+#else
+#define HLOGE(fmt, ...) do {} while (0)
+#endif
+#if HALO_LOG_LEVEL >= HLOG_LEVEL_WARN
+#define HLOGW(fmt, ...) hlog_emit(HLOG_LEVEL_WARN, "" fmt, ##__VA_ARGS__)
+#else
+#define HLOGW(fmt, ...) do {} while (0)
+#endif
+#if HALO_LOG_LEVEL >= HLOG_LEVEL_INFO
+#define HLOGI(fmt, ...) hlog_emit(HLOG_LEVEL_INFO, "" fmt, ##__VA_ARGS__)
+#else
+#define HLOGI(fmt, ...) do {} while (0)
+#endif
+#if HALO_LOG_LEVEL >= HLOG_LEVEL_DEBUG
+#define HLOGD(fmt, ...) hlog_emit(HLOG_LEVEL_DEBUG, "" fmt, ##__VA_ARGS__)
+#else
+#define HLOGD(fmt, ...) do {} while (0)
+#endif
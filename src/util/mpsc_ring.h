@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Bounded multi-producer / single-consumer ring, lock-free (per-slot sequence
+// numbers). Any task may push; one task pops. N must be a power of two.
+// A full ring rejects the push, so producers never block.
+template <typename T, size_t N>
+class MpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing size must be a power of two");
+public:
+  MpscRing(){ for (size_t i=0; i<N; ++i) cells_[i].seq.store((uint32_t)i, std::memory_order_relaxed); }
+
+  bool push(const T& v){
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& c = cells_[h & (N - 1)];
+      const int32_t d = (int32_t)(c.seq.load(std::memory_order_acquire) - h);
+      if (d == 0) {
+        if (head_.compare_exchange_weak(h, h + 1, std::memory_order_relaxed)) {
+          c.val = v;
+          c.seq.store(h + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (d < 0) {
+        return false;                                   // full
+      } else {
+        h = head_.load(std::memory_order_relaxed);      // another producer took it
+      }
+    }
+  }
+
+  bool pop(T& out){
+    Cell& c = cells_[tail_ & (N - 1)];
+    if ((int32_t)(c.seq.load(std::memory_order_acquire) - (tail_ + 1)) < 0) return false;   // empty or being written
+    out = c.val;
+    c.seq.store(tail_ + N, std::memory_order_release);
+    tail_++;
+    return true;
+  }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    T val;
+  };
+  Cell cells_[N];
+  std::atomic<uint32_t> head_{0};   // shared by producers
+  uint32_t tail_ = 0;               // consumer only
+};
@@ -0,0 +1,124 @@
+#include "prof.h"
+
+static const uint8_t PROF_WIRE_VERSION = 2;
+
+static const char* const NAMES[PROF_COUNT] = {
+  "nav_ingest", "baro", "nav_parse", "fsm", "ble", "fdr", "state", "control", "ctl_period", "ui", "audio",
+  "lat_parse", "lat_fsm", "lat_strobe", "lat_audio", "lat_glass",
+  "nmea_push"
+};
+
+#if HALO_PROFILE
+
+struct ProfStat {
+  uint32_t count;
+  uint32_t min_cy;
+  uint32_t max_cy;
+  uint64_t sum_cy;
+  uint32_t mark_cy;
+  uint32_t last_tag;
+  uint16_t hist[PROF_BUCKETS];
+};
+static ProfStat stats[PROF_COUNT];
+static uint32_t cpuMhz = 0;
+
+// Stats are kept in cycles of a fixed reference clock so samples taken before
+// and after a frequency change (power manager) stay comparable.
+static const uint32_t REF_MHZ = 240;
+
+static inline uint32_t to_us(uint64_t cy){ return (uint32_t)(cy / REF_MHZ); }
+
+static void record_ref(ProfStat& s, uint32_t cycles){
+  if (s.count == 0 || cycles < s.min_cy) s.min_cy = cycles;
+  if (cycles > s.max_cy) s.max_cy = cycles;
+  s.sum_cy += cycles;
+  s.count++;
+
+  const uint32_t us = to_us(cycles);
+  int b = us ? (31 - __builtin_clz(us)) - 2 : 0;
+  if (b < 0) b = 0;
+  if (b >= PROF_BUCKETS) b = PROF_BUCKETS - 1;
+  if (s.hist[b] != 0xFFFF) s.hist[b]++;
+}
+
+void prof_record(ProfId id, uint32_t cycles){
+  if (!cpuMhz) cpuMhz = getCpuFrequencyMhz();
+  if (cpuMhz != REF_MHZ) cycles = (uint32_t)min<uint64_t>((uint64_t)cycles * REF_MHZ / cpuMhz, 0xFFFFFFFFull);
+  record_ref(stats[id], cycles);
+}
+
+void prof_set_cpu_mhz(uint32_t mhz){ cpuMhz = mhz; }
+
+void prof_mark(ProfId id){
+  const uint32_t now = ESP.getCycleCount();
+  ProfStat& s = stats[id];
+  if (s.mark_cy) prof_record(id, now - s.mark_cy);
+  s.mark_cy = now | 1;       // 0 means "no mark yet"
+}
+
+void prof_trace(ProfId stage, uint32_t tag){
+  ProfStat& s = stats[stage];
+  if (!tag || tag == s.last_tag) return;
+  s.last_tag = tag;
+  const uint64_t cy = (uint64_t)(prof_trace_now() - tag) * REF_MHZ;
+  record_ref(s, cy > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)cy);
+}
+
+void prof_reset(){
+  memset(stats, 0, sizeof(stats));
+  cpuMhz = getCpuFrequencyMhz();
+}
+
+static void fill(ProfWire& w, uint8_t id){
+  const ProfStat& s = stats[id];
+  w.id     = id;
+  w.count  = s.count;
+  w.min_us = to_us(s.min_cy);
+  w.avg_us = s.count ? to_us(s.sum_cy / s.count) : 0;
+  w.max_us = to_us(s.max_cy);
+  memcpy(w.hist, s.hist, sizeof(w.hist));
+}
+
+void prof_dump(Print& out){
+  out.printf("[PROF] %u MHz; us: count min avg max | log2 buckets <8,8,16,...,>=32768\n", (unsigned)cpuMhz);
+  for (uint8_t i=0; i<PROF_COUNT; ++i) {
+    ProfWire w; fill(w, i);
+    if (!w.count) continue;
+    out.printf("  %-10s %8lu %6lu %6lu %7lu |", NAMES[i], (unsigned long)w.count,
+               (unsigned long)w.min_us, (unsigned long)w.avg_us, (unsigned long)w.max_us);
+    for (uint8_t b=0; b<PROF_BUCKETS; ++b) out.printf(" %u", (unsigned)w.hist[b]);
+    out.println();
+  }
+}
+
+size_t prof_pack(uint8_t* dst, size_t cap, uint8_t first){
+  if (cap < 4) return 0;
+  size_t n = 4;
+  uint8_t count = 0;
+  for (uint8_t i=first; i<PROF_COUNT && n + sizeof(ProfWire) <= cap; ++i) {
+    ProfWire w; fill(w, i);
+    memcpy(dst + n, &w, sizeof(w));
+    n += sizeof(w); count++;
+  }
+  dst[0] = PROF_WIRE_VERSION;
+  dst[1] = PROF_COUNT;
+  dst[2] = first;
+  dst[3] = count;
+  return n;
+}
+
+#else  // !HALO_PROFILE
+
+void   prof_record(ProfId, uint32_t){}
+void   prof_mark(ProfId){}
+void   prof_trace(ProfId, uint32_t){}
+void   prof_reset(){}
+void   prof_set_cpu_mhz(uint32_t){}
+void   prof_dump(Print& out){ out.println("[PROF] disabled (build with -D HALO_PROFILE=1)"); (void)NAMES; }
+size_t prof_pack(uint8_t* dst, size_t cap, uint8_t first){
+  if (cap < 4) return 0;
+  dst[0] = PROF_WIRE_VERSION; dst[1] = 0; dst[2] = first; dst[3] = 0;
+  return 4;
+}
+
+#endif
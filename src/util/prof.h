@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Scoped cycle-counter profiler. Build with -D HALO_PROFILE=1 to enable;
+// with 0 the PROF_* macros compile to nothing.
+//
+// Alert latency: each PFLAA line is tagged with the time its first byte came
+// off the UART (prof_trace_now(), as seen by the nav poll) and the tag travels
+// with `alert`. Each PROF_LAT_* stage records now - tag once per tag.
+//
+// Each section keeps count/min/avg/max and a log2 histogram of microseconds in
+// static memory. A section must only be recorded from one task (tasks are
+// pinned, so the per-core CCOUNT is consistent); readers tolerate tearing.
+#ifndef HALO_PROFILE
+#define HALO_PROFILE 0
+#endif
+
+enum ProfId : uint8_t {
+  PROF_NAV_INGEST,      // nav task: UART framing
+  PROF_BARO,            // sensor task: BMP280 read
+  PROF_NAV_PARSE,       // control: nav_tick (NMEA parse)
+  PROF_FSM,             // control: app_fsm_tick
+  PROF_BLE,             // control: bleTick
+  PROF_FDR,             // control: fdr_tick
+  PROF_STATE,           // control: state store commit
+  PROF_CONTROL,         // control: whole tick
+  PROF_CONTROL_PERIOD,  // control: start-to-start period
+  PROF_UI,              // ui task: drawPage
+  PROF_AUDIO,           // audio task: dfp_tick
+  PROF_LAT_PARSE,       // alert latency: PFLAA parsed into `alert`
+  PROF_LAT_FSM,         //   consumed by app_fsm_tick
+  PROF_LAT_STROBE,      //   strobe cadence changed
+  PROF_LAT_AUDIO,       //   DFPlayer play command written
+  PROF_LAT_GLASS,       //   traffic page drawn
+  PROF_NMEA_PUSH,       // control: NMEA line into the BLE bridge ring
+  PROF_COUNT
+};
+
+// Histogram: bucket 0 < 8 us, bucket k covers [2^(k+2), 2^(k+3)) us, last is open-ended
+static constexpr uint8_t PROF_BUCKETS = 14;
+
+// BLE wire record, one per section (little-endian)
+struct __attribute__((packed)) ProfWire {
+  uint8_t  id;
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t avg_us;
+  uint32_t max_us;
+  uint16_t hist[PROF_BUCKETS];     // saturating
+};
+static_assert(sizeof(ProfWire) == 45, "profiler wire record");
+
+void   prof_record(ProfId id, uint32_t cycles);
+void   prof_mark(ProfId id);                    // record the time since the previous mark
+void   prof_trace(ProfId stage, uint32_t tag);  // record now - tag; 0 or a repeated tag is ignored
+void   prof_reset();
+void   prof_set_cpu_mhz(uint32_t mhz);          // call on a CPU clock change (app/power.h)
+void   prof_dump(Print& out);
+size_t prof_pack(uint8_t* dst, size_t cap, uint8_t first = 0);  // [version][total][first][n][n x ProfWire]
+
+// Trace tag for the alert path: esp_timer microseconds, never 0 (0 = untagged)
+static inline uint32_t prof_trace_now(){ return (uint32_t)esp_timer_get_time() | 1u; }
+
+#if HALO_PROFILE
+struct ProfScope {
+  ProfId   id;
+  uint32_t t0;
+  explicit ProfScope(ProfId i) : id(i), t0(ESP.getCycleCount()) {}
+  ~ProfScope(){ prof_record(id, ESP.getCycleCount() - t0); }
+};
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b)  PROF_CAT2(a, b)
+#define PROF_SCOPE(id)  ProfScope PROF_CAT(_prof_, __LINE__)(id)
+#define PROF_MARK(id)   prof_mark(id)
+#else
+#define PROF_SCOPE(id)  do {} while (0)
+#define PROF_MARK(id)   do {} while (0)
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Bounded single-producer / single-consumer queue, lock-free.
+// One task may push and one other task may pop; N must be a power of two.
+// Indices run freely and are masked on access, so all N slots are usable.
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+public:
+  bool push(const T& v){
+    const uint32_t h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) >= N) return false;   // full
+    buf_[h & (N - 1)] = v;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& out){
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return false;       // empty
+    out = buf_[t & (N - 1)];
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const { return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire); }
+
+private:
+  T buf_[N];
+  std::atomic<uint32_t> head_{0};   // written by producer only
+  std::atomic<uint32_t> tail_{0};   // written by consumer only
+};
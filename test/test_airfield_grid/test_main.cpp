@@ -0,0 +1,148 @@
+// Host tests for nav/airfield_grid.h: the gridded nearest-field lookup
+// against a brute-force scan, on databases laid out like tools/mkairfields.py.
+//   pio test -e native -f test_airfield_grid
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "nav/airfield_grid.h"
+#include "util/fixed_trig.h"
+
+void setUp(){}
+void tearDown(){}
+
+static const float M_PER_E7 = 0.0111319491f;
+
+static uint32_t rng = 0x2545F491u;
+static uint32_t rnd(){ rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+static int32_t rnd_in(int32_t lo, int32_t hi){ return lo + (int32_t)(rnd() % (uint32_t)(hi - lo)); }
+
+static int64_t floor_div(int64_t a, int64_t b){ return a / b - (a % b != 0 && (a < 0) != (b < 0)); }
+
+// Same layout as mkairfields.build(): origin snapped down to the cell size,
+// records sorted by cell, non-empty cells listed with a sentinel.
+static std::vector<uint8_t> build(std::vector<AssetAirfield> f, int32_t cell){
+  int32_t latMin = INT32_MAX, lonMin = INT32_MAX, latMax = INT32_MIN, lonMax = INT32_MIN;
+  for (const AssetAirfield& a : f) {
+    latMin = std::min(latMin, a.lat_e7); latMax = std::max(latMax, a.lat_e7);
+    lonMin = std::min(lonMin, a.lon_e7); lonMax = std::max(lonMax, a.lon_e7);
+  }
+  AssetAirfields h;
+  h.lat0_e7 = (int32_t)(floor_div(latMin, cell) * cell);
+  h.lon0_e7 = (int32_t)(floor_div(lonMin, cell) * cell);
+  h.cell_e7 = (uint32_t)cell;
+  h.rows = (uint16_t)(((int64_t)latMax - h.lat0_e7) / cell + 1);
+  h.cols = (uint16_t)(((int64_t)lonMax - h.lon0_e7) / cell + 1);
+  auto cell_of = [&](const AssetAirfield& a){
+    return (uint32_t)((((int64_t)a.lat_e7 - h.lat0_e7) / cell) * h.cols + ((int64_t)a.lon_e7 - h.lon0_e7) / cell);
+  };
+  std::stable_sort(f.begin(), f.end(), [&](const AssetAirfield& a, const AssetAirfield& b){ return cell_of(a) < cell_of(b); });
+  std::vector<AssetAirfieldCell> cells;
+  for (uint32_t i = 0; i < f.size(); ++i) {
+    if (cells.empty() || cells.back().id != cell_of(f[i])) cells.push_back(AssetAirfieldCell{ cell_of(f[i]), i });
+  }
+  h.count = (uint32_t)f.size(); h.ncells = (uint32_t)cells.size();
+  cells.push_back(AssetAirfieldCell{ 0xFFFFFFFFu, h.count });
+
+  std::vector<uint8_t> out(sizeof(h) + cells.size() * sizeof(AssetAirfieldCell) + f.size() * sizeof(AssetAirfield));
+  uint8_t* p = out.data();
+  memcpy(p, &h, sizeof(h)); p += sizeof(h);
+  memcpy(p, cells.data(), cells.size() * sizeof(AssetAirfieldCell)); p += cells.size() * sizeof(AssetAirfieldCell);
+  memcpy(p, f.data(), f.size() * sizeof(AssetAirfield));
+  return out;
+}
+
+static std::vector<AssetAirfield> random_fields(int n, int32_t lat0, int32_t lat1, int32_t lon0, int32_t lon1){
+  std::vector<AssetAirfield> f(n);
+  for (int i = 0; i < n; ++i) {
+    f[i].lat_e7 = rnd_in(lat0, lat1); f[i].lon_e7 = rnd_in(lon0, lon1);
+    f[i].elev_ft = (int16_t)(i % 5000);
+    memset(f[i].ident, 0, sizeof(f[i].ident));
+  }
+  return f;
+}
+
+// Brute force with the lookup's own metric (cos(lat) from the Q15 table at
+// the query point), so the two must agree on the distance exactly.
+static float brute(const AirfieldGrid& g, int32_t lat, int32_t lon, float max_m){
+  const float kLon = fmaxf(0.02f, icos(bam_from_deg(lat * 1e-7f)) / (float)Q15_ONE);
+  float best = max_m * max_m;
+  bool found = false;
+  for (uint32_t i = 0; i < g.db->count; ++i) {
+    const float n = (float)((int64_t)g.recs[i].lat_e7 - lat) * M_PER_E7;
+    const float e = (float)((int64_t)g.recs[i].lon_e7 - lon) * (M_PER_E7 * kLon);
+    const float d2 = n * n + e * e;
+    if (d2 <= best) { best = d2; found = true; }
+  }
+  return found ? sqrtf(best) : -1.0f;
+}
+
+static void check_queries(const AirfieldGrid& g, int32_t lat0, int32_t lat1, int32_t lon0, int32_t lon1,
+                          float max_m, int n){
+  for (int q = 0; q < n; ++q) {
+    const int32_t lat = rnd_in(lat0, lat1), lon = rnd_in(lon0, lon1);
+    float d = -1.0f;
+    const AssetAirfield* hit = airfield_grid_nearest(g, lat, lon, max_m, &d);
+    const float want = brute(g, lat, lon, max_m);
+    if (want < 0) { TEST_ASSERT_TRUE_MESSAGE(hit == nullptr, "found a field outside the radius"); continue; }
+    TEST_ASSERT_TRUE_MESSAGE(hit != nullptr, "missed the nearest field");
+    TEST_ASSERT_TRUE_MESSAGE(d == want, "not the nearest field");
+  }
+}
+
+static void test_matches_brute_force_europe(){
+  const int32_t lat0 = 430000000, lat1 = 550000000, lon0 = -50000000, lon1 = 200000000;
+  std::vector<uint8_t> blob = build(random_fields(3000, lat0, lat1, lon0, lon1), 5000000);
+  AirfieldGrid g;
+  TEST_ASSERT_TRUE(airfield_grid_open(g, blob.data(), (uint32_t)blob.size()));
+  check_queries(g, lat0 - 10000000, lat1 + 10000000, lon0 - 10000000, lon1 + 10000000, 50000.0f, 4000);
+  check_queries(g, lat0, lat1, lon0, lon1, 5000.0f, 4000);
+}
+
+// Small cells (many rows per query), high latitude (wide longitude span) and
+// a grid straddling the equator and the prime meridian
+static void test_matches_brute_force_edges(){
+  {
+    std::vector<uint8_t> blob = build(random_fields(800, 600000000, 700000000, -200000000, 300000000), 500000);
+    AirfieldGrid g;
+    TEST_ASSERT_TRUE(airfield_grid_open(g, blob.data(), (uint32_t)blob.size()));
+    check_queries(g, 590000000, 710000000, -210000000, 310000000, 50000.0f, 3000);
+  }
+  {
+    std::vector<uint8_t> blob = build(random_fields(800, -20000000, 20000000, -20000000, 20000000), 5000000);
+    AirfieldGrid g;
+    TEST_ASSERT_TRUE(airfield_grid_open(g, blob.data(), (uint32_t)blob.size()));
+    check_queries(g, -30000000, 30000000, -30000000, 30000000, 20000.0f, 3000);
+  }
+}
+
+static void test_far_query_finds_nothing(){
+  std::vector<uint8_t> blob = build(random_fields(100, 480000000, 490000000, 110000000, 120000000), 5000000);
+  AirfieldGrid g;
+  TEST_ASSERT_TRUE(airfield_grid_open(g, blob.data(), (uint32_t)blob.size()));
+  TEST_ASSERT_TRUE(airfield_grid_nearest(g, -330000000, 1510000000, 50000.0f) == nullptr);
+  TEST_ASSERT_TRUE(airfield_grid_nearest(g, 895000000, -1790000000, 50000.0f) == nullptr);
+}
+
+static void test_rejects_malformed(){
+  std::vector<uint8_t> blob = build(random_fields(50, 480000000, 490000000, 110000000, 120000000), 5000000);
+  AirfieldGrid g;
+  TEST_ASSERT_TRUE(!airfield_grid_open(g, blob.data(), (uint32_t)blob.size() - 1));   // truncated
+  TEST_ASSERT_TRUE(!airfield_grid_open(g, blob.data(), 8));
+  TEST_ASSERT_TRUE(!airfield_grid_open(g, nullptr, 0));
+  AssetAirfields* h = (AssetAirfields*)blob.data();
+  h->count -= 1;                                                                    // sentinel mismatch
+  TEST_ASSERT_TRUE(!airfield_grid_open(g, blob.data(), (uint32_t)blob.size()));
+  TEST_ASSERT_TRUE(g.db == nullptr);
+  TEST_ASSERT_TRUE(airfield_grid_nearest(g, 485000000, 115000000, 50000.0f) == nullptr);
+}
+
+int main(int, char**){
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_brute_force_europe);
+  RUN_TEST(test_matches_brute_force_edges);
+  RUN_TEST(test_far_query_finds_nothing);
+  RUN_TEST(test_rejects_malformed);
+  return UNITY_END();
+}
@@ -0,0 +1,125 @@
+// Host tests for util/fixed_trig.h: table lookups against libm, and the
+// integer o'clock sector against the float mapping it replaced.
+//   pio test -e native -f test_fixed_trig
+#include <unity.h>
+#include <math.h>
+#include "util/fixed_trig.h"
+
+void setUp(){}
+void tearDown(){}
+
+static double bam_rad(uint32_t a){ return (double)a * (2.0 * M_PI / 65536.0); }
+
+// Wrapped angle difference in degrees, [-180, 180)
+static double ddeg(double a, double b){
+  double d = fmod(a - b + 540.0, 360.0) - 180.0;
+  return d;
+}
+
+// The mapping clock_sector() replaced (policy.h before fixed_trig.h), in
+// double so the reference itself doesn't round: k covers [k*30-15, k*30+15).
+static int clock_float(double rel_deg){
+  rel_deg = fmod(rel_deg, 360.0);
+  if (rel_deg < 0) rel_deg += 360.0;
+  const int s = ((int)((rel_deg + 15.0) / 30.0)) % 12;
+  return s ? s : 12;
+}
+
+static void test_isin_icos_within_one_lsb(){
+  int worst = 0;
+  for (uint32_t a = 0; a < 65536; ++a) {
+    const int es = abs(isin((bam16_t)a) - (int)lround(sin(bam_rad(a)) * 32767.0));
+    const int ec = abs(icos((bam16_t)a) - (int)lround(cos(bam_rad(a)) * 32767.0));
+    if (es > worst) worst = es;
+    if (ec > worst) worst = ec;
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_INT(1, worst);
+}
+
+static void test_isin_exact_at_quadrants(){
+  TEST_ASSERT_EQUAL_INT(0,       isin(0));
+  TEST_ASSERT_EQUAL_INT(32767,   isin(BAM_90));
+  TEST_ASSERT_EQUAL_INT(0,       isin(BAM_180));
+  TEST_ASSERT_EQUAL_INT(-32767,  isin(0xC000));
+  TEST_ASSERT_EQUAL_INT(32767,   icos(0));
+  TEST_ASSERT_EQUAL_INT(-32767,  icos(BAM_180));
+}
+
+static void test_iatan2_within_hundredth_degree(){
+  double worst = 0.0;
+  // Every direction at several radii, from a few metres to beyond 16 bits
+  static const double radii[] = { 3.0, 47.0, 1000.0, 32767.0, 100000.0, 2.0e9 };
+  for (double r : radii) {
+    for (uint32_t a = 0; a < 65536; a += 7) {
+      const int32_t y = (int32_t)lround(r * sin(bam_rad(a)));
+      const int32_t x = (int32_t)lround(r * cos(bam_rad(a)));
+      if (!x && !y) continue;
+      const double ref = atan2((double)y, (double)x) * 180.0 / M_PI;
+      const double err = fabs(ddeg(bam_to_deg(iatan2(y, x)), ref));
+      if (err > worst) worst = err;
+    }
+  }
+  TEST_ASSERT_LESS_THAN_FLOAT(0.01, worst);
+}
+
+static void test_iatan2_compass_convention(){
+  TEST_ASSERT_EQUAL_UINT16(0,      iatan2(0, 0));
+  TEST_ASSERT_EQUAL_UINT16(0,      iatan2(0, 100));       // north
+  TEST_ASSERT_EQUAL_UINT16(BAM_90, iatan2(100, 0));       // east
+  TEST_ASSERT_EQUAL_UINT16(BAM_180, iatan2(0, -100));     // south
+  TEST_ASSERT_EQUAL_UINT16(0xC000, iatan2(-100, 0));      // west
+  TEST_ASSERT_EQUAL_UINT16(0x2000, iatan2(INT32_MAX, INT32_MAX));
+}
+
+// Every BAM value maps to the float sector, except the few that sit within
+// half a BAM below a boundary, which clock_sector() deliberately rounds up.
+static void test_clock_sector_matches_float_mapping(){
+  int biased = 0;
+  for (uint32_t a = 0; a < 65536; ++a) {
+    const double deg = (double)a * 360.0 / 65536.0;
+    const int want = clock_float(deg);
+    const int got  = clock_sector((bam16_t)a);
+    if (got == want) continue;
+    const double toBoundary = fmod(deg + 15.0, 30.0);          // distance past the lower boundary
+    TEST_ASSERT_TRUE_MESSAGE(30.0 - toBoundary < 180.0 / 65536.0, "mismatch away from a boundary");
+    TEST_ASSERT_EQUAL_INT(want % 12 + 1, got);
+    biased++;
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_INT(12, biased);
+}
+
+// As policy.h uses it: degrees in, each side rounded to BAM, then differenced.
+// On a 0.1° grid only exact sector boundaries may land on either side.
+static void test_clock_sector_from_degree_pairs(){
+  for (int h = 0; h < 3600; h += 7) {
+    for (int t = 0; t < 3600; ++t) {
+      const int relTenths = ((t - h) % 3600 + 3600) % 3600;
+      const int want = clock_float(relTenths / 10.0);
+      const int got  = clock_sector((bam16_t)(bam_from_deg(t / 10.0f) - bam_from_deg(h / 10.0f)));
+      if (got == want) continue;
+      TEST_ASSERT_TRUE_MESSAGE((relTenths + 150) % 300 == 0, "mismatch away from a boundary");
+      TEST_ASSERT_EQUAL_INT((want + 10) % 12 + 1, got);            // one sector back
+    }
+  }
+}
+
+static void test_clock_sector_centres(){
+  for (int k = 0; k < 12; ++k) {
+    TEST_ASSERT_EQUAL_UINT8(k ? k : 12, clock_sector(bam_from_deg(k * 30.0f)));
+  }
+  TEST_ASSERT_EQUAL_UINT8(3,  clock_sector(bam_from_deg(75.0f)));
+  TEST_ASSERT_EQUAL_UINT8(12, clock_sector(bam_from_deg(-14.9f)));
+  TEST_ASSERT_EQUAL_UINT8(11, clock_sector(bam_from_deg(-15.1f)));
+}
+
+int main(int, char**){
+  UNITY_BEGIN();
+  RUN_TEST(test_isin_icos_within_one_lsb);
+  RUN_TEST(test_isin_exact_at_quadrants);
+  RUN_TEST(test_iatan2_within_hundredth_degree);
+  RUN_TEST(test_iatan2_compass_convention);
+  RUN_TEST(test_clock_sector_matches_float_mapping);
+  RUN_TEST(test_clock_sector_from_degree_pairs);
+  RUN_TEST(test_clock_sector_centres);
+  return UNITY_END();
+}
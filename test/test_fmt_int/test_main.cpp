@@ -0,0 +1,77 @@
+// Host tests for util/fmt_int.h: every formatter against the snprintf
+// format it replaces, including the int32 extremes.
+//   pio test -e native -f test_fmt_int
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "util/fmt_int.h"
+
+void setUp(){}
+void tearDown(){}
+
+static const int32_t SAMPLES[] = {
+  0, 1, -1, 9, 10, -10, 99, 100, 12345, -12345, 999999, 1000000,
+  2147483647, -2147483647, (int32_t)0x80000000,
+};
+
+static void test_fmt_u32_matches_printf(){
+  char got[16], want[16];
+  static const uint32_t v[] = { 0u, 7u, 10u, 65535u, 1000000000u, 4294967295u };
+  for (uint32_t x : v) {
+    for (uint8_t w = 1; w <= 10; ++w) {
+      const uint8_t n = fmt_u32(got, x, w);
+      snprintf(want, sizeof(want), "%0*lu", (int)w, (unsigned long)x);
+      TEST_ASSERT_EQUAL_STRING(want, got);
+      TEST_ASSERT_EQUAL_INT((int)strlen(want), n);
+    }
+  }
+}
+
+static void test_fmt_i32_matches_printf(){
+  char got[16], want[16];
+  for (int32_t x : SAMPLES) {
+    const uint8_t n = fmt_i32(got, x);
+    snprintf(want, sizeof(want), "%ld", (long)x);
+    TEST_ASSERT_EQUAL_STRING(want, got);
+    TEST_ASSERT_EQUAL_INT((int)strlen(want), n);
+  }
+}
+
+static void test_fmt_fixed_matches_printf(){
+  char got[32], want[32];
+  for (int32_t x : SAMPLES) {
+    for (uint8_t d = 0; d <= 3; ++d) {
+      const uint8_t n = fmt_fixed(got, x, d);
+      long long scale = 1;
+      for (uint8_t i = 0; i < d; ++i) scale *= 10;
+      const long long a = x < 0 ? -(long long)x : (long long)x;
+      if (d) snprintf(want, sizeof(want), "%s%lld.%0*lld", x < 0 ? "-" : "", a / scale, (int)d, a % scale);
+      else   snprintf(want, sizeof(want), "%lld", (long long)x);
+      TEST_ASSERT_EQUAL_STRING(want, got);
+      TEST_ASSERT_EQUAL_INT((int)strlen(want), n);
+    }
+  }
+  fmt_fixed(got, -5, 1);  TEST_ASSERT_EQUAL_STRING("-0.5", got);
+  fmt_fixed(got, 123, 1); TEST_ASSERT_EQUAL_STRING("12.3", got);
+}
+
+static void test_chaining(){
+  char b[24], *p = b;
+  p += fmt_i32(p, -42);
+  p += fmt_str(p, "kts ");
+  p += fmt_fixed(p, 15, 1);
+  p += fmt_str(p, " km");
+  TEST_ASSERT_EQUAL_STRING("-42kts 1.5 km", b);
+  TEST_ASSERT_EQUAL_INT((int)strlen(b), (int)(p - b));
+  TEST_ASSERT_EQUAL_INT(0, fmt_str(b, ""));
+  TEST_ASSERT_EQUAL_STRING("", b);
+}
+
+int main(int, char**){
+  UNITY_BEGIN();
+  RUN_TEST(test_fmt_u32_matches_printf);
+  RUN_TEST(test_fmt_i32_matches_printf);
+  RUN_TEST(test_fmt_fixed_matches_printf);
+  RUN_TEST(test_chaining);
+  return UNITY_END();
+}
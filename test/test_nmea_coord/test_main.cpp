@@ -0,0 +1,73 @@
+// Host tests for nav/nmea_coord.h: NMEA ddmm.mmmm fields to degrees * 1e7.
+//   pio test -e native -f test_nmea_coord
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include "nav/nmea_coord.h"
+
+void setUp(){}
+void tearDown(){}
+
+static int32_t parse(const char* t, char hemi, bool* ok = nullptr){
+  int32_t v = 0x7FFFFFFF;
+  const bool r = nmea_coord_e7(t, hemi, v);
+  if (ok) *ok = r;
+  return r ? v : 0x7FFFFFFF;
+}
+
+static void test_known_fixes(){
+  TEST_ASSERT_EQUAL_INT(481172833,   parse("4807.037", 'N'));    // 48°07.037'
+  TEST_ASSERT_EQUAL_INT(115166666,   parse("01131.000", 'E'));   // 11°31.000', truncated
+  TEST_ASSERT_EQUAL_INT(-338568000,  parse("3351.408", 'S'));
+  TEST_ASSERT_EQUAL_INT(-1512150000, parse("15112.900", 'W'));
+  TEST_ASSERT_EQUAL_INT(0,           parse("0000.0000", 'N'));
+  TEST_ASSERT_EQUAL_INT(500000000,   parse("5000", 'N'));        // no fraction
+  TEST_ASSERT_EQUAL_INT(899999998,   parse("8959.99999", 'N'));
+  TEST_ASSERT_EQUAL_INT(1799999998,  parse("17959.99999", 'E'));
+}
+
+// Sub-microminute digits beyond the fifth are ignored, not rounded
+static void test_extra_digits_truncate(){
+  TEST_ASSERT_EQUAL_INT(parse("4807.03712", 'N'), parse("4807.0371234", 'N'));
+}
+
+// Every 1/1000 minute over a degree agrees with the double conversion to
+// within the 1e-7 degree grid
+static void test_matches_double_conversion(){
+  char buf[16];
+  for (int deg = 0; deg < 90; deg += 7) {
+    for (int mm = 0; mm < 60000; mm += 13) {
+      snprintf(buf, sizeof(buf), "%02d%02d.%03d", deg, mm / 1000, mm % 1000);
+      const double want = (deg + (mm / 1000.0) / 60.0) * 1e7;
+      bool ok = false;
+      const int32_t got = parse(buf, 'N', &ok);
+      TEST_ASSERT_TRUE(ok);
+      TEST_ASSERT_TRUE_MESSAGE(fabs(got - want) <= 1.0, buf);
+    }
+  }
+}
+
+static void test_rejects_malformed(){
+  bool ok = true;
+  static const char* const bad[] = { "", "12", "123456.0", "48a7.037", "4807.0x7", "4860.000", "9000.000", ".5" };
+  for (const char* t : bad) { parse(t, 'N', &ok); TEST_ASSERT_TRUE_MESSAGE(!ok, t); }
+  parse("18000.000", 'E', &ok); TEST_ASSERT_TRUE(!ok);         // longitude > 179°
+  parse("4807.037", 'X', &ok);  TEST_ASSERT_TRUE(!ok);         // hemisphere
+  parse("4807.037", 0, &ok);    TEST_ASSERT_TRUE(!ok);
+}
+
+static void test_failure_leaves_output(){
+  int32_t v = 1234;
+  TEST_ASSERT_TRUE(!nmea_coord_e7("xx", 'N', v));
+  TEST_ASSERT_EQUAL_INT(1234, v);
+}
+
+int main(int, char**){
+  UNITY_BEGIN();
+  RUN_TEST(test_known_fixes);
+  RUN_TEST(test_extra_digits_truncate);
+  RUN_TEST(test_matches_double_conversion);
+  RUN_TEST(test_rejects_malformed);
+  RUN_TEST(test_failure_leaves_output);
+  return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Replay a recorded flight into HALO over the USB data port (see
+src/app/data_port.h) and decode what comes back.
+
+Usage:
+    tools/hilport.py /dev/ttyACM0 flight.nmea            # as fast as the parser takes it
+    tools/hilport.py /dev/ttyACM0 flight.nmea --lps 20   # real-time pacing, lines per second
+    tools/hilport.py /dev/ttyACM0 capture.gdl90 --rate 20 --states states.csv
+
+The input is sent as-is: NMEA text, a raw GDL90 capture (0x7E-framed), or a
+mix of both. The script switches the port into data mode (console key D),
+streams the file, then returns it to the console. Writes are credit paced:
+no more than WINDOW bytes beyond the rx_bytes count of the last stats frame
+are in flight, because the device drops input once its RX buffer is full.
+State frames are written as CSV if --states is given; the stats frames are
+printed once a second.
+Needs pyserial (pip install pyserial).
+"""
+import argparse
+import struct
+import sys
+import threading
+import time
+
+FLAG, ESC = 0x7E, 0x7D
+MSG_STATE, MSG_STATS, MSG_CTRL = 0x48, 0x49, 0x4A
+WINDOW = 2048                                  # DP_RX_WINDOW (src/app/data_port.h)
+CHUNK = 256
+LIVE = struct.Struct("<IIihhHHhBBBBHhhhHH")   # HaloLiveFrame (src/app/live_frame.h)
+LIVE_FIELDS = ("t_ms utc_epoch alt_dm agl_ft vs_cms sog_dkt trk_ddeg temp_dC state flags "
+               "strobe_level alarm alert_age_ms relN_m relE_m relV_m dist_m bearing_ddeg").split()
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        c = i << 8
+        for _ in range(8):
+            c = ((c << 1) ^ 0x1021) if c & 0x8000 else c << 1
+        table.append(c & 0xFFFF)
+    return table
+
+
+CRC_TABLE = _crc_table()
+
+
+def crc16(data):
+    """GDL90 FCS, computed as in the ICD (src/nav/gdl90.cpp)."""
+    crc = 0
+    for b in data:
+        crc = CRC_TABLE[crc >> 8] ^ ((crc << 8) & 0xFFFF) ^ b
+    return crc
+
+
+def frame(msg):
+    body = bytes(msg) + struct.pack("<H", crc16(msg))
+    out = bytearray([FLAG])
+    for b in body:
+        out += bytes([ESC, b ^ 0x20]) if b in (FLAG, ESC) else bytes([b])
+    return bytes(out + bytes([FLAG]))
+
+
+def frames(stream):
+    """Yield unescaped, CRC-checked messages from an iterator of byte chunks."""
+    buf, inside, esc = bytearray(), False, False
+    for chunk in stream:
+        for b in chunk:
+            if b == FLAG:
+                if inside and len(buf) >= 3 and crc16(buf[:-2]) == buf[-2] | buf[-1] << 8:
+                    yield bytes(buf[:-2])
+                buf, inside, esc = bytearray(), True, False
+            elif inside:
+                if esc:
+                    buf.append(b ^ 0x20)
+                    esc = False
+                elif b == ESC:
+                    esc = True
+                else:
+                    buf.append(b)
+
+
+class Credit:
+    """Bytes the device has acknowledged (rx_bytes of the latest stats frame)."""
+
+    def __init__(self):
+        self.cond = threading.Condition()
+        self.acked = 0
+        self.full = 0
+
+    def update(self, rx_bytes, rx_full):
+        with self.cond:
+            self.acked, self.full = rx_bytes, rx_full
+            self.cond.notify_all()
+
+    def wait(self, sent, timeout):
+        """Block until `sent` is within the window; False if no ack arrives."""
+        with self.cond:
+            return self.cond.wait_for(lambda: sent - self.acked <= WINDOW, timeout)
+
+
+def reader(port, states, credit, stop):
+    def chunks():
+        while not stop.is_set():
+            yield port.read(port.in_waiting or 1)
+    last = 0.0
+    for m in frames(chunks()):
+        if m[0] == MSG_STATS and len(m) >= 25:
+            lines, fr, dropped, bad, rx_bytes, rx_full = struct.unpack_from("<6I", m, 1)
+            credit.update(rx_bytes, rx_full)
+            if time.time() - last >= 1.0:
+                last = time.time()
+                print("halo: %d lines, %d frames, %d dropped, %d bad, %d bytes in, RX full %d"
+                      % (lines, fr, dropped, bad, rx_bytes, rx_full))
+        elif m[0] == MSG_STATE and states and len(m) >= 2 + LIVE.size:
+            states.write(",".join(str(v) for v in LIVE.unpack_from(m, 2)) + "\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port")
+    ap.add_argument("input")
+    ap.add_argument("--lps", type=float, default=0, help="pace NMEA lines per second (0 = as fast as credited)")
+    ap.add_argument("--no-credit", action="store_true", help="ignore the device's credit window (may lose input)")
+    ap.add_argument("--rate", type=int, default=10, help="state frames per second (0-50)")
+    ap.add_argument("--states", help="write decoded state frames to this CSV")
+    args = ap.parse_args()
+    try:
+        import serial
+    except ImportError:
+        sys.exit("hilport: needs pyserial (pip install pyserial)")
+
+    port = serial.Serial(args.port, 115200, timeout=0.2)
+    port.write(b"D")
+    time.sleep(0.2)
+    port.reset_input_buffer()
+    port.write(frame([MSG_CTRL, ord("R"), max(0, min(50, args.rate))]))
+
+    states = open(args.states, "w") if args.states else None
+    if states:
+        states.write(",".join(LIVE_FIELDS) + "\n")
+    credit = Credit()
+    stop = threading.Event()
+    th = threading.Thread(target=reader, args=(port, states, credit, stop), daemon=True)
+    th.start()
+
+    data = open(args.input, "rb").read()
+    if args.lps > 0:
+        pieces = data.splitlines(keepends=True)
+    else:
+        pieces = [data[i:i + CHUNK] for i in range(0, len(data), CHUNK)]
+    sent = 0
+    t0 = time.time()
+    for i, piece in enumerate(pieces):
+        if not args.no_credit and not credit.wait(sent + len(piece), 3.0):
+            sys.exit("hilport: no credit from the device for 3 s (%d bytes sent)" % sent)
+        port.write(piece)
+        sent += len(piece)
+        if args.lps > 0:
+            time.sleep(max(0.0, t0 + (i + 1) / args.lps - time.time()))
+    port.flush()
+    dt = time.time() - t0
+    print("sent %d bytes in %.1f s (%.0f B/s)" % (sent, dt, sent / dt if dt else 0))
+
+    time.sleep(1.5)                      # let the last stats frame arrive
+    if credit.acked != sent or credit.full:
+        print("hilport: device took %d of %d bytes, RX full %d" % (credit.acked, sent, credit.full))
+    stop.set()
+    th.join(1.0)
+    port.write(frame([MSG_CTRL, ord("C")]))
+    if states:
+        states.close()
+
+
+if __name__ == "__main__":
+    main()
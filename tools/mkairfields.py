@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Build the HALO airfield database asset from an OpenAIP-style CSV.
+
+Usage:
+    tools/mkairfields.py airports.csv -o airfields.bin [--cell 0.5]
+    tools/mkairfields.py airports.csv --query 48.1173 11.5167
+
+Normally this runs from tools/mkassets.py ("airfields": "airports.csv" in
+the spec), which stores the result as the "airfields" asset; the standalone
+form is for checking an export.
+
+Columns are matched by header name (case-insensitive):
+    ident      icaoCode / icao / ident / code   (else the first 6 chars of name)
+    latitude   latitude / lat                   decimal degrees
+    longitude  longitude / lon / lng
+    elevation  elevation / elev / elevation_m / elevation_ft
+    unit       elevationUnit / elev_unit        "ft"/"FT"/1 = feet, else metres
+Rows without a position or elevation are skipped.
+
+Layout (see AssetAirfields in src/storage/asset_format.h): header, then the
+non-empty grid cells as (id, first record) sorted by id = row*cols+col from
+the south-west corner, plus a sentinel, then 16-byte records in cell order.
+"""
+import argparse
+import csv
+import math
+import struct
+import sys
+
+E7 = 10_000_000
+M_PER_E7 = 0.0111319491
+HEADER = struct.Struct("<iiIHHII")
+CELL = struct.Struct("<II")
+RECORD = struct.Struct("<iih6s")
+
+
+def pick(header, *names):
+    low = {h.strip().lower(): h for h in header}
+    for n in names:
+        if n.lower() in low:
+            return low[n.lower()]
+    return None
+
+
+def load(path, force_feet=False):
+    fields = []
+    with open(path, newline="", encoding="utf-8-sig") as f:
+        rows = csv.DictReader(f)
+        h = rows.fieldnames or []
+        c_id = pick(h, "icaoCode", "icao", "ident", "code")
+        c_name = pick(h, "name")
+        c_lat = pick(h, "latitude", "lat")
+        c_lon = pick(h, "longitude", "lon", "lng")
+        c_el = pick(h, "elevation", "elev", "elevation_m", "elevation_ft")
+        c_unit = pick(h, "elevationUnit", "elev_unit")
+        if not (c_lat and c_lon and c_el):
+            sys.exit("mkairfields: %s needs latitude, longitude and elevation columns" % path)
+        feet_col = force_feet or c_el.lower().endswith("_ft")
+        for r in rows:
+            try:
+                lat, lon, el = float(r[c_lat]), float(r[c_lon]), float(r[c_el])
+            except (TypeError, ValueError):
+                continue
+            if not (-90 < lat < 90 and -180 <= lon < 180):
+                continue
+            unit = (r.get(c_unit) or "").strip().lower() if c_unit else ""
+            ft = el if (feet_col or unit in ("ft", "1")) else el * 3.28084
+            ident = (r.get(c_id) or "").strip() if c_id else ""
+            if not ident and c_name:
+                ident = (r.get(c_name) or "").strip()
+            fields.append((round(lat * E7), round(lon * E7), max(-32768, min(32767, round(ft))),
+                           ident[:6].encode("ascii", "replace")))
+    if not fields:
+        sys.exit("mkairfields: no usable rows in %s" % path)
+    return fields
+
+
+def build(path, cell_deg=0.5, force_feet=False):
+    fields = load(path, force_feet)
+    cell = round(cell_deg * E7)
+    lat0 = math.floor(min(f[0] for f in fields) / cell) * cell
+    lon0 = math.floor(min(f[1] for f in fields) / cell) * cell
+    rows = (max(f[0] for f in fields) - lat0) // cell + 1
+    cols = (max(f[1] for f in fields) - lon0) // cell + 1
+    if rows > 0xFFFF or cols > 0xFFFF:
+        sys.exit("mkairfields: grid too large, use a bigger --cell")
+
+    def cell_of(f):
+        return ((f[0] - lat0) // cell) * cols + (f[1] - lon0) // cell
+
+    fields.sort(key=cell_of)
+    cells = []
+    for i, f in enumerate(fields):
+        if not cells or cells[-1][0] != cell_of(f):
+            cells.append((cell_of(f), i))
+    out = bytearray(HEADER.pack(lat0, lon0, cell, rows, cols, len(fields), len(cells)))
+    for c in cells + [(0xFFFFFFFF, len(fields))]:
+        out += CELL.pack(*c)
+    for f in fields:
+        out += RECORD.pack(*f)
+    return bytes(out), fields, (rows, cols, len(cells))
+
+
+def nearest(fields, lat, lon, max_m=50000.0):
+    k = math.cos(math.radians(lat))
+    best = None
+    for f in fields:
+        n = (f[0] - lat * E7) * M_PER_E7
+        e = (f[1] - lon * E7) * M_PER_E7 * k
+        d = math.hypot(n, e)
+        if d <= max_m and (best is None or d < best[0]):
+            best = (d, f)
+    return best
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("csv")
+    ap.add_argument("-o", "--output")
+    ap.add_argument("--cell", type=float, default=0.5, help="grid cell size in degrees (default 0.5)")
+    ap.add_argument("--feet", action="store_true", help="elevation column is in feet")
+    ap.add_argument("--query", nargs=2, type=float, metavar=("LAT", "LON"))
+    args = ap.parse_args()
+
+    blob, fields, (rows, cols, ncells) = build(args.csv, args.cell, args.feet)
+    print("%d fields in %d cells (%dx%d grid), %d bytes" % (len(fields), ncells, rows, cols, len(blob)))
+    if args.output:
+        open(args.output, "wb").write(blob)
+    if args.query:
+        hit = nearest(fields, *args.query)
+        print("nearest: %s, %d ft, %.0f m" % (hit[1][3].decode(), hit[1][2], hit[0]) if hit else "nearest: none within 50 km")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Build the HALO asset partition image (see src/storage/assets.h).
+
+Usage:
+    tools/mkassets.py assets.json -o assets.bin
+    esptool.py --chip esp32s3 write_flash 0x390000 assets.bin
+
+The spec is JSON; file paths are relative to it:
+
+    {
+      "images":  { "splash": "splash.png" },
+      "fonts":   { "label": "FreeSans9pt7b.h" },
+      "prompts": { "boot": 1, "nav_ok": 2, "takeoff": 3, "landing": 7,
+                   "level": 10, "high": 11, "low": 12, "clock1": 21 },
+      "airfields": "airports.csv"
+    }
+
+Images are read with Pillow and stored as RGB565. Fonts are Adafruit GFX
+font headers as written by fontconvert; a font named "label" sets the
+pre-flight page labels. Prompt names are the
+ones in src/app/prompts.cpp; entries left out keep the built-in track.
+"airfields" is an OpenAIP-style CSV turned into the gridded database by
+tools/mkairfields.py; use { "file": ..., "cell": 0.5, "feet": false } to
+pass its options.
+"""
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = 0x54534148          # "HAST"
+VERSION = 1
+PARTITION_SIZE = 0x60000    # partitions.csv "assets"
+
+ASSET_IMAGE, ASSET_FONT, ASSET_MANIFEST, ASSET_AIRFIELDS = 1, 2, 4, 5
+HEADER = struct.Struct("<IHHII")
+ENTRY = struct.Struct("<20sHHII")
+
+
+def rgb565(img):
+    img = img.convert("RGB")
+    out = bytearray()
+    for r, g, b in img.getdata():
+        out += struct.pack("<H", ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+    return bytes(out)
+
+
+def open_image(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("mkassets: images need Pillow (pip install pillow)")
+    return Image.open(path)
+
+
+def build_image(path):
+    img = open_image(path)
+    return struct.pack("<HH", img.width, img.height) + rgb565(img)
+
+
+def c_array(src, kind):
+    m = re.search(r"const\s+" + kind + r"\s+\w+\[\]\s*(?:PROGMEM\s*)?=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        sys.exit("mkassets: no %s array in font header" % kind)
+    return re.sub(r"//[^\n]*|/\*.*?\*/", "", m.group(1), flags=re.S)
+
+
+def build_font(path):
+    src = open(path).read()
+    bitmap = bytes(int(v, 0) for v in re.findall(r"0x[0-9A-Fa-f]+|\d+", c_array(src, "uint8_t")))
+    glyphs = [tuple(int(v, 0) for v in re.findall(r"-?\w+", g))
+              for g in re.findall(r"\{([^{}]*)\}", c_array(src, "GFXglyph"))]
+    m = re.search(r"const\s+GFXfont\s+\w+\s*(?:PROGMEM\s*)?=\s*\{[^,]*,[^,]*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\}", src)
+    if not m:
+        sys.exit("mkassets: no GFXfont in %s" % path)
+    first, last, y_adv = (int(v, 0) for v in m.groups())
+    if last - first + 1 != len(glyphs) or last > 255:
+        sys.exit("mkassets: %s: glyph count does not match first/last" % path)
+    out = bytearray(struct.pack("<BBBB", first, last, y_adv, 0))
+    for off, w, h, adv, xo, yo in glyphs:
+        out += struct.pack("<HBBBbbx", off, w, h, adv, xo, yo)   # GFXglyph, padded to 8
+    return bytes(out + bitmap)
+
+
+def build_manifest(prompts):
+    out = bytearray(struct.pack("<HH", len(prompts), 0))
+    for name, track in sorted(prompts.items()):
+        if len(name) > 11 or not 1 <= int(track) <= 3000:
+            sys.exit("mkassets: bad prompt %r -> %r" % (name, track))
+        out += struct.pack("<12sHH", name.encode(), int(track), 0)
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("spec")
+    ap.add_argument("-o", "--output", default="assets.bin")
+    args = ap.parse_args()
+
+    spec = json.load(open(args.spec))
+    base = os.path.dirname(os.path.abspath(args.spec))
+    items = []
+    for name, path in spec.get("images", {}).items():
+        items.append((name, ASSET_IMAGE, build_image(os.path.join(base, path))))
+    for name, path in spec.get("fonts", {}).items():
+        items.append((name, ASSET_FONT, build_font(os.path.join(base, path))))
+    if spec.get("prompts"):
+        items.append(("prompts", ASSET_MANIFEST, build_manifest(spec["prompts"])))
+    if spec.get("airfields"):
+        sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+        import mkairfields
+        af = spec["airfields"]
+        af = af if isinstance(af, dict) else {"file": af}
+        data, _, _ = mkairfields.build(os.path.join(base, af["file"]), af.get("cell", 0.5), af.get("feet", False))
+        items.append(("airfields", ASSET_AIRFIELDS, data))
+
+    offset = HEADER.size + ENTRY.size * len(items)
+    table, blob = bytearray(), bytearray()
+    for name, kind, data in items:
+        if len(name) > 19:
+            sys.exit("mkassets: asset name too long: %s" % name)
+        pad = (-(offset + len(blob))) % 4
+        blob += b"\0" * pad
+        table += ENTRY.pack(name.encode(), kind, 0, offset + len(blob), len(data))
+        blob += data
+    total = offset + len(blob)
+    if total > PARTITION_SIZE:
+        sys.exit("mkassets: %d bytes does not fit the 0x%X partition" % (total, PARTITION_SIZE))
+
+    with open(args.output, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(items), zlib.crc32(bytes(table)) & 0xFFFFFFFF, total))
+        f.write(table)
+        f.write(blob)
+    print("%s: %d assets, %d of %d bytes" % (args.output, len(items), total, PARTITION_SIZE))
+
+
+if __name__ == "__main__":
+    main()